@@ -0,0 +1,376 @@
+#include "AssetLoader.h"
+#include "PolyphaseResampler.h"
+#include "ExecutionContext.h"
+
+namespace
+{
+    constexpr int chunkSize = 32768;    /**< Samples decoded between cancellation checks. */
+}
+
+//==============================================================================
+class AssetLoader::Worker  : public juce::Thread
+{
+public:
+    Worker (AssetLoader& l, int index)
+        : juce::Thread ("Asset loader " + juce::String (index)), loader (l) {}
+
+    void run() override
+    {
+        ExecutionContext::ThreadScope context (getThreadName(), ExecutionContext::Role::worker);
+
+        while (! threadShouldExit())
+        {
+            Job job;
+
+            if (loader.popJob (job))
+            {
+                const ExecutionContext::ScopedCycle cycle (context);
+                loader.runJob (job, *this);
+            }
+            else
+            {
+                wait (500);
+            }
+        }
+    }
+
+private:
+    AssetLoader& loader;
+};
+
+//==============================================================================
+AssetLoader::AssetLoader (int numThreads)
+{
+    formatManager.registerBasicFormats();
+    idleEvent.signal();
+
+    for (int i = 0; i < juce::jmax (1, numThreads); ++i)
+    {
+        auto* worker = workers.add (new Worker (*this, i));
+        worker->startThread (juce::Thread::Priority::background);
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        const juce::ScopedLock sl (queueLock);
+        queue.clear();
+
+        for (auto* slot : slots)
+            slot->cancelRequests();
+    }
+
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto* worker : workers)
+    {
+        worker->notify();
+        worker->stopThread (5000);
+    }
+
+    cancelPendingUpdate();
+    stopTimer();
+    reclaim();
+}
+
+//==============================================================================
+juce::uint32 AssetLoader::load (AssetSlot<AudioAsset>& slot, const Request& request)
+{
+    addSlot (slot);
+
+    if (request.file == juce::File())
+    {
+        cancel (slot);
+        slot.publish (nullptr);
+        triggerAsyncUpdate();
+        return 0;
+    }
+
+    juce::uint32 generation = 0;
+
+    {
+        const juce::ScopedLock sl (queueLock);
+
+        // Anything still queued for this slot is stale now
+        queue.erase (std::remove_if (queue.begin(), queue.end(), [&slot] (const Job& j) { return j.slot == &slot; }),
+                     queue.end());
+
+        generation = slot.beginRequest();
+        queue.push_back ({ &slot, request, generation, nextSequence++ });
+        idleEvent.reset();
+    }
+
+    for (auto* worker : workers)
+        worker->notify();
+
+    return generation;
+}
+
+void AssetLoader::cancel (AssetSlot<AudioAsset>& slot)
+{
+    const juce::ScopedLock sl (queueLock);
+    queue.erase (std::remove_if (queue.begin(), queue.end(), [&slot] (const Job& j) { return j.slot == &slot; }),
+                 queue.end());
+    slot.cancelRequests();
+
+    if (queue.empty() && numRunning == 0)
+        idleEvent.signal();
+}
+
+void AssetLoader::remove (AssetSlot<AudioAsset>& slot)
+{
+    cancel (slot);
+
+    // A running load keeps using the slot until it notices the cancellation
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl (queueLock);
+
+            if (std::none_of (runningJobs.begin(), runningJobs.end(), [&slot] (const Job& j) { return j.slot == &slot; }))
+            {
+                slots.removeFirstMatchingValue (&slot);
+                return;
+            }
+        }
+
+        jobFinished.wait (100);
+    }
+}
+
+int AssetLoader::getNumPending() const
+{
+    const juce::ScopedLock sl (queueLock);
+    return (int) queue.size() + numRunning;
+}
+
+bool AssetLoader::waitUntilIdle (int timeoutMilliseconds)
+{
+    return idleEvent.wait ((double) timeoutMilliseconds);
+}
+
+bool AssetLoader::waitUntilLoaded (AssetSlot<AudioAsset>& slot, juce::uint32 generation, int timeoutMilliseconds)
+{
+    const auto isThisRequest = [&] (const Job& j) { return j.slot == &slot && j.generation == generation; };
+    const auto deadline = juce::Time::getMillisecondCounterHiRes() + timeoutMilliseconds;
+
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl (queueLock);
+
+            if (std::none_of (queue.begin(), queue.end(), isThisRequest)
+                && std::none_of (runningJobs.begin(), runningJobs.end(), isThisRequest))
+                return true;
+        }
+
+        const auto remaining = deadline - juce::Time::getMillisecondCounterHiRes();
+
+        if (remaining <= 0.0)
+            return false;
+
+        // Superseded requests leave the queue without a signal, so check again now and then
+        jobFinished.wait (juce::jmin (remaining, 100.0));
+    }
+}
+
+int AssetLoader::reclaim()
+{
+    juce::Array<AssetSlot<AudioAsset>*> slotsToReclaim;
+
+    {
+        const juce::ScopedLock sl (queueLock);
+        slotsToReclaim = slots;
+    }
+
+    int stillHeld = 0;
+
+    for (auto* slot : slotsToReclaim)
+        stillHeld += slot->reclaim();
+
+    return stillHeld;
+}
+
+//==============================================================================
+bool AssetLoader::popJob (Job& job)
+{
+    const juce::ScopedLock sl (queueLock);
+
+    if (queue.empty())
+        return false;
+
+    // Highest priority first, oldest first among equals
+    const auto best = std::min_element (queue.begin(), queue.end(), [] (const Job& a, const Job& b)
+    {
+        return a.request.priority != b.request.priority ? a.request.priority > b.request.priority
+                                                        : a.sequence < b.sequence;
+    });
+
+    job = *best;
+    queue.erase (best);
+    runningJobs.push_back (job);
+    ++numRunning;
+    return true;
+}
+
+void AssetLoader::runJob (const Job& job, const juce::Thread& thread)
+{
+    auto isCancelled = [&]
+    {
+        return thread.threadShouldExit() || ! job.slot->isCurrentRequest (job.generation);
+    };
+
+    if (auto asset = decode (job, isCancelled))
+    {
+        if (job.slot->publishIfCurrent (std::move (asset), job.generation))
+            triggerAsyncUpdate();
+    }
+    else if (! isCancelled())
+    {
+        ++numFailed;
+    }
+
+    {
+        const juce::ScopedLock sl (queueLock);
+        runningJobs.erase (std::find_if (runningJobs.begin(), runningJobs.end(),
+                                         [&job] (const Job& j) { return j.slot == job.slot && j.generation == job.generation; }));
+
+        if (--numRunning == 0 && queue.empty())
+            idleEvent.signal();
+    }
+
+    jobFinished.signal();
+}
+
+std::unique_ptr<AudioAsset> AssetLoader::decode (const Job& job, const std::function<bool()>& isCancelled)
+{
+    const auto& file = job.request.file;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    // Memory-mapped where possible: no read() syscalls, and the OS pages the file in as we go
+    if (auto* format = formatManager.findFormatForFileExtension (file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            reader = std::move (mapped);
+    }
+
+    if (reader == nullptr)
+        reader.reset (formatManager.createReaderFor (file));
+
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+        return nullptr;
+
+    const auto numChannels = (int) reader->numChannels;
+    const auto sourceRate = reader->sampleRate;
+    const auto available = job.request.maxSamples >= 0 ? juce::jmin (job.request.maxSamples, reader->lengthInSamples)
+                                                       : reader->lengthInSamples;
+    const auto numSamples = (int) juce::jmin (available, (juce::int64) std::numeric_limits<int>::max() / 2);
+
+    auto asset = std::make_unique<AudioAsset>();
+    asset->file = file;
+    asset->generation = job.generation;
+    asset->fileLengthInSamples = reader->lengthInSamples;
+    asset->sampleRate = sourceRate;
+
+    juce::AudioBuffer<float> source (numChannels, numSamples);
+    std::vector<float*> destination ((size_t) numChannels);
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        if (isCancelled())
+            return nullptr;
+
+        const auto num = juce::jmin (chunkSize, numSamples - start);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            destination[(size_t) ch] = source.getWritePointer (ch, start);
+
+        if (! reader->read (destination.data(), numChannels, start, num))
+            return nullptr;
+    }
+
+    const auto targetRate = job.request.targetSampleRate;
+
+    if (targetRate <= 0.0 || std::abs (targetRate - sourceRate) < 1.0e-6)
+    {
+        asset->audio = std::move (source);
+        return asset;
+    }
+
+    // Resample in chunks. The resampler's output n is centred on source sample
+    // n * step + getCentreOffset(), so leading silence of that length keeps
+    // the asset starting on its first sample, and trailing silence flushes the tail.
+    PolyphaseResampler resampler;
+    resampler.prepare (sourceRate, targetRate, numChannels, chunkSize);
+    resampler.reset();
+
+    const auto outputLength = (int) std::round (numSamples / resampler.getStep());
+    const auto leadIn = (int) PolyphaseResampler::getCentreOffset();
+    const auto flushLength = PolyphaseResampler::numTaps * 2;
+
+    juce::AudioBuffer<float> resampled (numChannels, outputLength + resampler.getMaxOutputSamples (chunkSize));
+    juce::AudioBuffer<float> silence (numChannels, flushLength);
+    silence.clear();
+
+    std::vector<const float*> input ((size_t) numChannels);
+    std::vector<float*> output ((size_t) numChannels);
+    int written = 0;
+
+    auto feed = [&] (const juce::AudioBuffer<float>& buffer, int start, int num)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            input[(size_t) ch] = buffer.getReadPointer (ch, start);
+            output[(size_t) ch] = resampled.getWritePointer (ch, written);
+        }
+
+        written += resampler.process (input.data(), num, output.data(), resampled.getNumSamples() - written);
+    };
+
+    feed (silence, 0, leadIn);
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        if (isCancelled())
+            return nullptr;
+
+        feed (source, start, juce::jmin (chunkSize, numSamples - start));
+    }
+
+    if (written < outputLength)
+        feed (silence, 0, flushLength);
+
+    asset->audio.setSize (numChannels, outputLength);
+    asset->audio.clear();
+
+    if (const auto numToCopy = juce::jmin (outputLength, written); numToCopy > 0)
+        for (int ch = 0; ch < numChannels; ++ch)
+            asset->audio.copyFrom (ch, 0, resampled, ch, 0, numToCopy);
+
+    asset->sampleRate = targetRate;
+    return asset;
+}
+
+void AssetLoader::addSlot (AssetSlot<AudioAsset>& slot)
+{
+    const juce::ScopedLock sl (queueLock);
+    slots.addIfNotAlreadyThere (&slot);
+}
+
+//==============================================================================
+void AssetLoader::handleAsyncUpdate()
+{
+    // Whatever the audio thread still holds goes on the next tick
+    if (reclaim() > 0)
+        startTimer (50);
+}
+
+void AssetLoader::timerCallback()
+{
+    if (reclaim() == 0)
+        stopTimer();
+}
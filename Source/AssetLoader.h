@@ -0,0 +1,127 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+#include "AssetSlot.h"
+
+/** A decoded audio file, ready for the audio thread. Immutable once published. */
+struct AudioAsset
+{
+    juce::AudioBuffer<float> audio;
+    double sampleRate = 0.0;            /**< The rate of audio, after any resampling. */
+    juce::File file;
+    juce::int64 fileLengthInSamples = 0; /**< The whole file's length at its own rate, even when only a preload was read. */
+    juce::uint32 generation = 0;        /**< The request that produced it, as returned by AssetLoader::load(). */
+};
+
+//==============================================================================
+/**
+    Loads audio assets on background threads and publishes them through an
+    AssetSlot, so state restores and preset switches never wait on disk.
+
+    Requests go into a queue ordered by priority, then age, and are served
+    by a small pool of worker threads. A new request for a slot supersedes
+    the old one: queued work for the slot is dropped, and a load already
+    running notices at its next chunk and stops. Files are decoded through
+    memory-mapped readers where the format supports it (WAV, AIFF) and
+    through ordinary readers otherwise, and are optionally resampled to the
+    processing rate with PolyphaseResampler.
+
+    Replaced assets are reclaimed on the message thread once the audio thread
+    has let go of them. Without a message loop (offline renders, tests) call
+    reclaim() yourself.
+
+    Plugin instances share one loader, and so its workers, through a
+    juce::SharedResourcePointer<AssetLoader>. Each instance must remove() its
+    slots before they go, since the loader outlives them.
+*/
+class AssetLoader  : private juce::AsyncUpdater,
+                     private juce::Timer
+{
+public:
+    //==============================================================================
+    struct Request
+    {
+        juce::File file;
+        double targetSampleRate = 0.0;      /**< Resample to this rate, or 0 to keep the file's rate. */
+        int priority = 0;                   /**< Higher runs first. */
+        juce::int64 maxSamples = -1;        /**< Read only this many source samples (a preload), or -1 for all. */
+    };
+
+    explicit AssetLoader (int numThreads = 2);
+    ~AssetLoader() override;
+
+    //==============================================================================
+    /**
+        Queues a load into slot and returns at once, superseding anything still
+        pending for that slot. An empty file clears the slot instead. The slot
+        must outlive the loader. Returns the request's generation, which the
+        published asset carries.
+    */
+    juce::uint32 load (AssetSlot<AudioAsset>& slot, const Request& request);
+
+    /** Drops queued work for the slot and stops a running load at its next check. */
+    void cancel (AssetSlot<AudioAsset>& slot);
+
+    /**
+        Message thread: cancels the slot's work, waits for a load running into
+        it to stop, and forgets the slot, which may then be destroyed.
+    */
+    void remove (AssetSlot<AudioAsset>& slot);
+
+    /** Queued plus running loads, for every slot. */
+    int getNumPending() const;
+
+    /** Blocks until every load, for every slot, has finished or the timeout passes. For offline renders and tests. */
+    bool waitUntilIdle (int timeoutMilliseconds);
+
+    /**
+        Blocks until the request load() returned generation for has finished,
+        failed or been superseded, or the timeout passes. Unlike
+        waitUntilIdle(), it doesn't wait for other slots' loads, so an offline
+        render isn't held up by every other instance sharing the loader.
+    */
+    bool waitUntilLoaded (AssetSlot<AudioAsset>& slot, juce::uint32 generation, int timeoutMilliseconds);
+
+    /** Frees replaced assets the audio thread has released. Returns how many are still held. */
+    int reclaim();
+
+    /** Loads that failed to open or decode since construction. */
+    int getNumFailed() const noexcept   { return numFailed.load(); }
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        AssetSlot<AudioAsset>* slot = nullptr;
+        Request request;
+        juce::uint32 generation = 0;
+        juce::uint64 sequence = 0;
+    };
+
+    class Worker;
+
+    bool popJob (Job& job);
+    void runJob (const Job& job, const juce::Thread& thread);
+    std::unique_ptr<AudioAsset> decode (const Job& job, const std::function<bool()>& isCancelled);
+    void addSlot (AssetSlot<AudioAsset>& slot);
+
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    juce::AudioFormatManager formatManager;
+
+    mutable juce::CriticalSection queueLock;
+    std::vector<Job> queue;
+    juce::Array<AssetSlot<AudioAsset>*> slots;     /**< Every slot loaded into, for reclaim(). */
+    std::vector<Job> runningJobs;                   /**< Each running load, for remove() and waitUntilLoaded(). */
+    juce::uint64 nextSequence = 0;
+    int numRunning = 0;
+    juce::WaitableEvent idleEvent { true };
+    juce::WaitableEvent jobFinished;
+
+    std::atomic<int> numFailed { 0 };
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AssetLoader)
+};
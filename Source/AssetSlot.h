@@ -0,0 +1,149 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+/**
+    Hands a heavy, immutable object (a sample, an IR, a wavetable) from a
+    loader thread to the audio thread without locks on the audio side.
+
+    This is RCU with a single reader. publish() swaps the new object in with
+    one atomic exchange and retires the old one. The audio thread brackets its
+    use with acquire()/release() (or a ScopedRead), which advertises the
+    pointer it holds. reclaim(), run on the message thread, deletes every
+    retired object the audio thread isn't holding. The audio thread never
+    allocates, frees or waits.
+
+    Each slot also carries a request generation. A loader bumps it when a new
+    request for the slot arrives, so older work can notice it has been
+    superseded and give up early.
+
+    Only one thread may read at a time, which is the case for an
+    AudioProcessor's processBlock().
+*/
+template <typename ObjectType>
+class AssetSlot
+{
+public:
+    //==============================================================================
+    AssetSlot() = default;
+
+    ~AssetSlot()
+    {
+        delete current.load();
+
+        for (auto* r : retired)
+            delete r;
+    }
+
+    //==============================================================================
+    /** Audio thread: returns the current object (or nullptr) and keeps it alive until release(). */
+    const ObjectType* acquire() noexcept
+    {
+        auto* object = current.load();
+
+        // Re-check after advertising, so a concurrent reclaim() either sees
+        // the hazard or we see the newer object
+        for (;;)
+        {
+            hazard.store (object);
+            auto* latest = current.load();
+
+            if (latest == object)
+                return object;
+
+            object = latest;
+        }
+    }
+
+    /** Audio thread: ends the use started by acquire(). */
+    void release() noexcept     { hazard.store (nullptr); }
+
+    /** Holds the current object for the lifetime of the scope, typically one processBlock(). */
+    class ScopedRead
+    {
+    public:
+        explicit ScopedRead (AssetSlot& s) noexcept : slot (s), object (s.acquire()) {}
+        ~ScopedRead() noexcept                          { slot.release(); }
+
+        const ObjectType* get() const noexcept          { return object; }
+        const ObjectType* operator->() const noexcept   { return object; }
+        explicit operator bool() const noexcept         { return object != nullptr; }
+
+    private:
+        AssetSlot& slot;
+        const ObjectType* object;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRead)
+    };
+
+    //==============================================================================
+    /** Any thread but the audio thread: replaces the object. Pass nullptr to clear the slot. */
+    void publish (std::unique_ptr<ObjectType> next)
+    {
+        const juce::ScopedLock sl (lock);
+        retire (current.exchange (next.release()));
+    }
+
+    /**
+        Publishes only if generation is still the slot's latest request, so a
+        superseded load that finishes late can't overwrite a newer one.
+    */
+    bool publishIfCurrent (std::unique_ptr<ObjectType> next, juce::uint32 generation)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (! isCurrentRequest (generation))
+            return false;
+
+        retire (current.exchange (next.release()));
+        return true;
+    }
+
+    /**
+        Message thread: deletes retired objects the audio thread can no longer
+        reach. Returns the number still waiting because the reader holds one.
+    */
+    int reclaim()
+    {
+        const juce::ScopedLock sl (lock);
+        const auto* inUse = hazard.load();
+
+        const auto reclaimable = std::partition (retired.begin(), retired.end(),
+                                                 [inUse] (const ObjectType* r) { return r == inUse; });
+
+        for (auto it = reclaimable; it != retired.end(); ++it)
+            delete *it;
+
+        retired.erase (reclaimable, retired.end());
+        return (int) retired.size();
+    }
+
+    //==============================================================================
+    /** Starts a new request, superseding any earlier one. Returns its generation. */
+    juce::uint32 beginRequest() noexcept                        { return ++generation; }
+
+    /** True while no newer request has been made since generation was issued. */
+    bool isCurrentRequest (juce::uint32 requestGeneration) const noexcept { return generation.load() == requestGeneration; }
+
+    /** Supersedes any outstanding request without starting a new one. */
+    void cancelRequests() noexcept                              { ++generation; }
+
+private:
+    //==============================================================================
+    void retire (ObjectType* old)
+    {
+        if (old != nullptr)
+            retired.push_back (old);
+    }
+
+    std::atomic<ObjectType*> current { nullptr };
+    std::atomic<const ObjectType*> hazard { nullptr };  /**< What the audio thread is holding, if anything. */
+    std::atomic<juce::uint32> generation { 0 };
+
+    juce::CriticalSection lock;                         /**< Publishers and reclaim() only; never the reader. */
+    std::vector<ObjectType*> retired;
+
+    JUCE_DECLARE_NON_COPYABLE (AssetSlot)
+};
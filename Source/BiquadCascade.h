@@ -0,0 +1,121 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+    A cascade of biquads that processes several channels at once, one channel
+    per SIMD lane.
+
+    Samples are interleaved so that each juce::dsp::SIMDRegister holds one
+    sample of every channel in the group (stereo fills two lanes, 7.1.4 needs
+    three groups of four). Coefficients and state are stored stage by stage as
+    structure-of-arrays, so a whole stage is a handful of vector multiply-adds
+    per sample regardless of the channel count.
+*/
+class BiquadCascade
+{
+public:
+    //==============================================================================
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int) Vec::SIMDNumElements;
+    static constexpr int maxStages = 8;
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+        /** RBJ cookbook peaking filter, normalised so a0 == 1. */
+        static Coefficients makePeak (double sampleRate, float frequency, float q, float gainDecibels) noexcept
+        {
+            const auto w0 = juce::MathConstants<double>::twoPi * juce::jmin ((double) frequency, 0.45 * sampleRate) / sampleRate;
+            const auto alpha = std::sin (w0) / (2.0 * q);
+            const auto a = std::pow (10.0, gainDecibels / 40.0);
+            const auto cosW0 = std::cos (w0);
+            const auto a0 = 1.0 + alpha / a;
+
+            return { (float) ((1.0 + alpha * a) / a0),
+                     (float) (-2.0 * cosW0 / a0),
+                     (float) ((1.0 - alpha * a) / a0),
+                     (float) (-2.0 * cosW0 / a0),
+                     (float) ((1.0 - alpha / a) / a0) };
+        }
+    };
+
+    //==============================================================================
+    /**
+        Inactive stages are skipped entirely. A stage's state is cleared when it
+        is switched off, so it resumes cleanly from identity coefficients.
+    */
+    void setStageActive (int stage, bool shouldBeActive) noexcept
+    {
+        if (! shouldBeActive && stages[stage].active)
+            resetStage (stage);
+
+        stages[stage].active = shouldBeActive;
+    }
+
+    bool isStageActive (int stage) const noexcept   { return stages[stage].active; }
+
+    /** Sets one stage's coefficients for every lane. Keeps the stage's state. */
+    void setCoefficients (int stage, const Coefficients& c) noexcept
+    {
+        auto& s = stages[stage];
+        s.b0 = Vec::expand (c.b0);
+        s.b1 = Vec::expand (c.b1);
+        s.b2 = Vec::expand (c.b2);
+        s.a1 = Vec::expand (c.a1);
+        s.a2 = Vec::expand (c.a2);
+    }
+
+    /** Clears one stage's state, e.g. when a band is switched back on. */
+    void resetStage (int stage) noexcept
+    {
+        stages[stage].s1 = Vec::expand (0.0f);
+        stages[stage].s2 = Vec::expand (0.0f);
+    }
+
+    void reset() noexcept
+    {
+        for (int i = 0; i < maxStages; ++i)
+            resetStage (i);
+    }
+
+    //==============================================================================
+    /** Runs numSamples interleaved samples through every active stage, in place. */
+    void process (Vec* data, int numSamples) noexcept
+    {
+        // Stage-outer keeps one stage's coefficients and state in registers for the whole run
+        for (auto& s : stages)
+        {
+            if (! s.active)
+                continue;
+
+            auto s1 = s.s1, s2 = s.s2;
+
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const auto x = data[n];
+                const auto y = s.b0 * x + s1;
+                s1 = s.b1 * x - s.a1 * y + s2;
+                s2 = s.b2 * x - s.a2 * y;
+                data[n] = y;
+            }
+
+            s.s1 = s1;
+            s.s2 = s2;
+        }
+    }
+
+private:
+    //==============================================================================
+    /** Transposed direct form II: coefficients plus the two state registers. */
+    struct Stage
+    {
+        Vec b0 = Vec::expand (1.0f), b1 = Vec::expand (0.0f), b2 = Vec::expand (0.0f);
+        Vec a1 = Vec::expand (0.0f), a2 = Vec::expand (0.0f);
+        Vec s1 = Vec::expand (0.0f), s2 = Vec::expand (0.0f);
+        bool active = false;
+    };
+
+    Stage stages[maxStages];
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/**
+    A static piece of UI (a knob body, a meter scale, a panel background)
+    rendered once into an Image and blitted on every paint after that.
+
+    The image is rendered at the context's physical pixel scale, so it stays
+    sharp on high-DPI displays, and is re-rendered only when the area's size
+    or the scale changes, or after invalidate(). With caching disabled the
+    layer is painted directly every time, which is what a benchmark compares
+    against.
+*/
+class CachedLayer
+{
+public:
+    //==============================================================================
+    /**
+        Draws the layer into area, first rendering it with paintLayer if the
+        cache is stale. paintLayer is called with a Graphics whose origin is
+        the top-left of the layer.
+    */
+    template <typename PaintFunction>
+    void draw (juce::Graphics& g, juce::Rectangle<int> area, PaintFunction&& paintLayer)
+    {
+        if (area.isEmpty())
+            return;
+
+        if (! cachingEnabled)
+        {
+            const juce::Graphics::ScopedSaveState state (g);
+            g.setOrigin (area.getPosition());
+            paintLayer (g);
+            return;
+        }
+
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (image.isNull() || area.getWidth() != width || area.getHeight() != height
+            || ! juce::approximatelyEqual (scale, imageScale))
+        {
+            width = area.getWidth();
+            height = area.getHeight();
+            imageScale = scale;
+            image = juce::Image (juce::Image::ARGB,
+                                 juce::jmax (1, juce::roundToInt ((float) width * scale)),
+                                 juce::jmax (1, juce::roundToInt ((float) height * scale)),
+                                 true);
+
+            juce::Graphics imageGraphics (image);
+            imageGraphics.addTransform (juce::AffineTransform::scale (scale));
+            paintLayer (imageGraphics);
+        }
+
+        g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / imageScale)
+                                                             .translated ((float) area.getX(), (float) area.getY()));
+    }
+
+    /** Drops the cached image, e.g. after a colour change. */
+    void invalidate() noexcept                      { image = {}; }
+
+    void setCachingEnabled (bool shouldCache)       { cachingEnabled = shouldCache; invalidate(); }
+    bool isCachingEnabled() const noexcept          { return cachingEnabled; }
+
+private:
+    //==============================================================================
+    juce::Image image;
+    int width = 0, height = 0;
+    float imageScale = 1.0f;
+    bool cachingEnabled = true;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <type_traits>
+
+/**
+    Channel-count-specialised processing kernels.
+
+    Every kernel is a template on the number of channels it processes. Mono and
+    stereo are instantiated with a compile-time constant so the channel loop is
+    unrolled and each sample is loaded once for all channels; any other layout
+    (LCR up to 7.1.4) goes through the dynamicChannelCount instantiation, which
+    falls back to a runtime channel loop over vectorised per-channel operations.
+
+    Kernels can also be given the block length as a template argument. When
+    the DSP runs in a fixed processing quantum, dispatchLength() hands them
+    that constant, so their sample loops have a known trip count the compiler
+    can unroll and vectorise without a remainder.
+*/
+namespace ChannelKernels
+{
+    /** Template argument used for layouts that have no dedicated specialisation. */
+    constexpr int dynamicChannelCount = 0;
+
+    template <int NumChannels>
+    using ChannelCount = std::integral_constant<int, NumChannels>;
+
+    /**
+        Calls fn with a ChannelCount<N> matching numChannels, so the callee can be
+        written once as a template and still get unrolled mono/stereo paths.
+    */
+    template <typename Fn>
+    inline void dispatch (int numChannels, Fn&& fn)
+    {
+        switch (numChannels)
+        {
+            case 1:  fn (ChannelCount<1>{}); break;
+            case 2:  fn (ChannelCount<2>{}); break;
+            default: fn (ChannelCount<dynamicChannelCount>{}); break;
+        }
+    }
+
+    /** Template argument used for block lengths that aren't known at compile time. */
+    constexpr int dynamicSampleCount = 0;
+
+    template <int NumSamples>
+    using SampleCount = std::integral_constant<int, NumSamples>;
+
+    /**
+        Calls fn with SampleCount<FixedLength> when numSamples is FixedLength,
+        and with SampleCount<dynamicSampleCount> otherwise, e.g. for the tail
+        of a split block. A FixedLength of 0 always takes the dynamic path.
+    */
+    template <int FixedLength, typename Fn>
+    inline void dispatchLength (int numSamples, Fn&& fn)
+    {
+        if constexpr (FixedLength > 0)
+        {
+            if (numSamples == FixedLength)
+            {
+                fn (SampleCount<FixedLength>{});
+                return;
+            }
+        }
+
+        fn (SampleCount<dynamicSampleCount>{});
+    }
+
+    /** Resolves a channel count or block length that may be fixed at compile time. */
+    template <int Count>
+    constexpr int resolve (int countAtRuntime) noexcept
+    {
+        return Count != 0 ? Count : countAtRuntime;
+    }
+
+    //==============================================================================
+    /** Multiplies every channel by the same constant gain. */
+    template <int NumChannels, int NumSamples = dynamicSampleCount>
+    inline void applyGain (float* const* channels, int numChannelsAtRuntime, float gain, int numSamplesAtRuntime) noexcept
+    {
+        const auto numSamples = resolve<NumSamples> (numSamplesAtRuntime);
+
+        if constexpr (NumChannels == 1 && NumSamples == dynamicSampleCount)
+        {
+            juce::FloatVectorOperations::multiply (channels[0], gain, numSamples);
+        }
+        else if constexpr (NumChannels == 1)
+        {
+            auto* data = channels[0];
+
+            for (int i = 0; i < NumSamples; ++i)
+                data[i] *= gain;
+        }
+        else if constexpr (NumChannels == 2)
+        {
+            auto* left  = channels[0];
+            auto* right = channels[1];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                left[i]  *= gain;
+                right[i] *= gain;
+            }
+        }
+        else
+        {
+            for (int ch = 0; ch < resolve<NumChannels> (numChannelsAtRuntime); ++ch)
+                juce::FloatVectorOperations::multiply (channels[ch], gain, numSamples);
+        }
+    }
+
+    /** Multiplies every channel by a per-sample gain ramp shared between channels. */
+    template <int NumChannels, int NumSamples = dynamicSampleCount>
+    inline void applyGainRamp (float* const* channels, int numChannelsAtRuntime, const float* gains, int numSamplesAtRuntime) noexcept
+    {
+        const auto numSamples = resolve<NumSamples> (numSamplesAtRuntime);
+
+        if constexpr (NumChannels == 1 && NumSamples == dynamicSampleCount)
+        {
+            juce::FloatVectorOperations::multiply (channels[0], gains, numSamples);
+        }
+        else if constexpr (NumChannels == 1)
+        {
+            auto* data = channels[0];
+
+            for (int i = 0; i < NumSamples; ++i)
+                data[i] *= gains[i];
+        }
+        else if constexpr (NumChannels == 2)
+        {
+            auto* left  = channels[0];
+            auto* right = channels[1];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto g = gains[i];
+                left[i]  *= g;
+                right[i] *= g;
+            }
+        }
+        else
+        {
+            for (int ch = 0; ch < resolve<NumChannels> (numChannelsAtRuntime); ++ch)
+                juce::FloatVectorOperations::multiply (channels[ch], gains, numSamples);
+        }
+    }
+}
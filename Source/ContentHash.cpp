@@ -0,0 +1,57 @@
+#include "ContentHash.h"
+
+//==============================================================================
+ContentHash& ContentHash::add (const void* data, size_t numBytes) noexcept
+{
+    auto* bytes = static_cast<const char*> (data);
+    length += numBytes;
+
+    for (; numBytes >= sizeof (juce::uint64); numBytes -= sizeof (juce::uint64), bytes += sizeof (juce::uint64))
+    {
+        juce::uint64 word;
+        std::memcpy (&word, bytes, sizeof (word));
+        addWord (word);
+    }
+
+    // The tail is zero-padded; the total length in get() keeps "ab" and "ab\0" apart
+    if (numBytes > 0)
+    {
+        juce::uint64 word = 0;
+        std::memcpy (&word, bytes, numBytes);
+        addWord (word);
+    }
+
+    return *this;
+}
+
+ContentHash& ContentHash::add (const juce::String& text) noexcept
+{
+    const auto utf8 = text.toRawUTF8();
+    return add (utf8, std::strlen (utf8)).add ((juce::uint8) 0);
+}
+
+ContentHash& ContentHash::add (const juce::AudioBuffer<float>& buffer) noexcept
+{
+    add (buffer.getNumChannels()).add (buffer.getNumSamples());
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        add (buffer.getReadPointer (ch), sizeof (float) * (size_t) buffer.getNumSamples());
+
+    return *this;
+}
+
+ContentHash& ContentHash::add (const juce::MidiBuffer& midi) noexcept
+{
+    add (midi.getNumEvents());
+
+    for (const auto metadata : midi)
+        add (metadata.samplePosition).add (metadata.numBytes).add (metadata.data, (size_t) metadata.numBytes);
+
+    return *this;
+}
+
+void ContentHash::addWord (juce::uint64 word) noexcept
+{
+    state = (state ^ mix (word)) * 0x9e3779b97f4a7c15ull;
+    state = (state << 31) | (state >> 33);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+    A fast, order-dependent 64-bit hash for render cache keys and seeds.
+
+    Data is consumed a 64-bit word at a time, each word scrambled with the
+    splitmix64 finaliser before it's folded in, so hashing a long input
+    buffer costs about as much as copying it. It is not cryptographic: it
+    tells identical inputs apart from different ones, nothing more. Words
+    are read in the machine's byte order, so keys are only comparable
+    between machines of the same endianness.
+*/
+class ContentHash
+{
+public:
+    //==============================================================================
+    ContentHash() = default;
+    explicit ContentHash (juce::uint64 seed) noexcept : state (mix (seed)) {}
+
+    //==============================================================================
+    ContentHash& add (const void* data, size_t numBytes) noexcept;
+
+    /** Adds a scalar's bytes, e.g. a float parameter value or a sample rate. */
+    template <typename Scalar, std::enable_if_t<std::is_arithmetic_v<Scalar>, int> = 0>
+    ContentHash& add (Scalar value) noexcept        { return add (&value, sizeof (value)); }
+
+    ContentHash& add (const juce::String& text) noexcept;
+
+    /** Adds the channel and sample counts, then every sample. */
+    ContentHash& add (const juce::AudioBuffer<float>& buffer) noexcept;
+
+    /** Adds every event's position and bytes. */
+    ContentHash& add (const juce::MidiBuffer& midi) noexcept;
+
+    /** The hash of everything added so far. */
+    juce::uint64 get() const noexcept               { return mix (state ^ length); }
+
+    //==============================================================================
+    /** The splitmix64 finaliser: a cheap bijective scramble of one word. */
+    static constexpr juce::uint64 mix (juce::uint64 x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+private:
+    //==============================================================================
+    void addWord (juce::uint64 word) noexcept;
+
+    juce::uint64 state = 0x9e3779b97f4a7c15ull;
+    juce::uint64 length = 0;
+};
@@ -12,26 +12,59 @@ CustomLookAndFeel::~CustomLookAndFeel()
 void CustomLookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos,
                                           const float rotaryStartAngle, const float rotaryEndAngle, juce::Slider& slider)
 {
+    juce::ignoreUnused (slider);
+
     auto radius = (float) juce::jmin (width / 2, height / 2) - 4.0f;
+
+    if (radius <= 0.0f)
+        return;
+
     auto centreX = (float) x + (float) width  * 0.5f;
     auto centreY = (float) y + (float) height * 0.5f;
-    auto rx = centreX - radius;
-    auto ry = centreY - radius;
     auto rw = radius * 2.0f;
     auto angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
 
-    g.setColour (juce::Colours::darkgrey);
-    g.fillEllipse (rx, ry, rw, rw);
+    // The body never changes with the value, so it's a blit after the first paint.
+    // The layer has a pixel of margin for the outline.
+    const auto diameter = juce::roundToInt (rw);
+    auto& layers = getKnobLayers (diameter);
+    const auto bodyArea = juce::Rectangle<int> (diameter + 2, diameter + 2)
+                              .withCentre ({ juce::roundToInt (centreX), juce::roundToInt (centreY) });
 
-    g.setColour (juce::Colours::black);
-    g.drawEllipse (rx, ry, rw, rw, 1.0f);
+    layers.body.draw (g, bodyArea, [rw] (juce::Graphics& lg)
+    {
+        lg.setColour (juce::Colours::darkgrey);
+        lg.fillEllipse (1.0f, 1.0f, rw, rw);
 
-    juce::Path p;
-    auto pointerLength = radius * 0.33f;
-    auto pointerThickness = 2.0f;
-    p.addRectangle (-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
-    p.applyTransform (juce::AffineTransform::rotation (angle).translated (centreX, centreY));
+        lg.setColour (juce::Colours::black);
+        lg.drawEllipse (1.0f, 1.0f, rw, rw, 1.0f);
+    });
 
     g.setColour (findColour (juce::Slider::thumbColourId));
-    g.fillPath (p);
+    g.fillPath (layers.pointer, juce::AffineTransform::rotation (angle).translated (centreX, centreY));
+}
+
+void CustomLookAndFeel::setLayerCachingEnabled (bool shouldCache)
+{
+    layerCachingEnabled = shouldCache;
+
+    for (auto& [diameter, layers] : knobLayers)
+        layers.body.setCachingEnabled (shouldCache);
+}
+
+CustomLookAndFeel::KnobLayers& CustomLookAndFeel::getKnobLayers (int diameter)
+{
+    auto [it, inserted] = knobLayers.try_emplace (diameter);
+    auto& layers = it->second;
+
+    if (inserted)
+    {
+        const auto radius = (float) diameter * 0.5f;
+        auto pointerLength = radius * 0.33f;
+        auto pointerThickness = 2.0f;
+        layers.pointer.addRectangle (-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
+        layers.body.setCachingEnabled (layerCachingEnabled);
+    }
+
+    return layers;
 }
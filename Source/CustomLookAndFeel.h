@@ -1,6 +1,14 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "CachedLayer.h"
 
+#include <map>
+
+/**
+    The plugin's look and feel. Rotary sliders keep their body (the filled
+    and outlined disc) in a CachedLayer per diameter, so a value change only
+    redraws the pointer on top of a blit.
+*/
 class CustomLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
@@ -10,6 +18,21 @@ public:
     void drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height, float sliderPos,
                            const float rotaryStartAngle, const float rotaryEndAngle, juce::Slider& slider) override;
 
+    /** Turns the knob body cache on or off, for paint benchmarks. */
+    void setLayerCachingEnabled (bool shouldCache);
+
 private:
+    /** What drawRotarySlider() keeps for one knob size. */
+    struct KnobLayers
+    {
+        CachedLayer body;
+        juce::Path pointer; /**< Pointing up from the centre, before rotation. */
+    };
+
+    KnobLayers& getKnobLayers (int diameter);
+
+    std::map<int, KnobLayers> knobLayers;
+    bool layerCachingEnabled = true;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CustomLookAndFeel)
 };
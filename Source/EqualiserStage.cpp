@@ -0,0 +1,132 @@
+#include "EqualiserStage.h"
+
+//==============================================================================
+void EqualiserStage::prepare (double newSampleRate, int, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+
+    groups.resize ((size_t) ((numChannels + BiquadCascade::lanes - 1) / BiquadCascade::lanes));
+    interleaved.resize ((size_t) subBlockSize);
+
+    for (auto& band : bands)
+    {
+        band.frequency.reset (sampleRate, 0.05);
+        band.gain.reset (sampleRate, 0.05);
+        band.q.reset (sampleRate, 0.05);
+    }
+
+    reset();
+}
+
+void EqualiserStage::reset()
+{
+    for (auto& band : bands)
+    {
+        band.frequency.setCurrentAndTargetValue (band.frequency.getTargetValue());
+        band.gain.setCurrentAndTargetValue (band.gain.getTargetValue());
+        band.q.setCurrentAndTargetValue (band.q.getTargetValue());
+    }
+
+    for (auto& group : groups)
+        group.reset();
+
+    needsUpdate = true;
+}
+
+void EqualiserStage::setBand (int index, float frequency, float gainDecibels, float q) noexcept
+{
+    auto& band = bands[index];
+
+    if (! juce::approximatelyEqual (band.frequency.getTargetValue(), frequency)
+        || ! juce::approximatelyEqual (band.gain.getTargetValue(), gainDecibels)
+        || ! juce::approximatelyEqual (band.q.getTargetValue(), q))
+    {
+        band.frequency.setTargetValue (frequency);
+        band.gain.setTargetValue (gainDecibels);
+        band.q.setTargetValue (q);
+        needsUpdate = true;
+    }
+}
+
+//==============================================================================
+void EqualiserStage::process (juce::AudioBuffer<float>& block) noexcept
+{
+    if (! needsUpdate && numActiveBands == 0)
+        return;
+
+    for (int start = 0; start < block.getNumSamples(); start += subBlockSize)
+    {
+        const auto num = juce::jmin (subBlockSize, block.getNumSamples() - start);
+
+        if (needsUpdate)
+            updateCoefficients (num);
+
+        if (numActiveBands > 0)
+            processChunk (block, start, num);
+    }
+}
+
+void EqualiserStage::updateCoefficients (int numSamples) noexcept
+{
+    numActiveBands = 0;
+    needsUpdate = false;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto& band = bands[i];
+
+        // Coefficients follow the smoothed values once per sub-block
+        const auto frequency = band.frequency.skip (numSamples);
+        const auto gain = band.gain.skip (numSamples);
+        const auto q = band.q.skip (numSamples);
+
+        const auto active = band.isActive();
+        const auto coefficients = BiquadCascade::Coefficients::makePeak (sampleRate, frequency, q, gain);
+
+        for (auto& group : groups)
+        {
+            group.setCoefficients (i, coefficients);
+            group.setStageActive (i, active);
+        }
+
+        numActiveBands += active ? 1 : 0;
+        needsUpdate = needsUpdate || band.isSmoothing();
+    }
+}
+
+void EqualiserStage::processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept
+{
+    constexpr auto lanes = BiquadCascade::lanes;
+    auto* samples = reinterpret_cast<float*> (interleaved.data());
+    const auto channelsInBlock = juce::jmin (numChannels, block.getNumChannels());
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        const auto firstChannel = (int) g * lanes;
+        const auto numLanes = juce::jmin (lanes, channelsInBlock - firstChannel);
+
+        if (numLanes <= 0)
+            break;
+
+        juce::FloatVectorOperations::clear (samples, num * lanes);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto* src = block.getReadPointer (firstChannel + lane, start);
+
+            for (int i = 0; i < num; ++i)
+                samples[i * lanes + lane] = src[i];
+        }
+
+        groups[g].process (interleaved.data(), num);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto* dst = block.getWritePointer (firstChannel + lane, start);
+
+            for (int i = 0; i < num; ++i)
+                dst[i] = samples[i * lanes + lane];
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BiquadCascade.h"
+
+/**
+    A parametric EQ made of peaking bands, one BiquadCascade stage per band,
+    with one cascade per group of SIMD lanes.
+
+    Band settings are targets: when one changes, frequency, gain and Q glide
+    over 50ms and the coefficients are recomputed once per subBlockSize
+    samples while gliding, never per sample. Bands sitting at 0dB are removed
+    from the cascade, so a flat EQ costs nothing and the cost of the rest
+    scales with the number of bands in use.
+*/
+class EqualiserStage
+{
+public:
+    //==============================================================================
+    static constexpr int numBands = 4;
+    static constexpr int subBlockSize = 32;
+
+    //==============================================================================
+    void prepare (double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+
+    /** Sets a band's target; cheap to call every block with unchanged values. */
+    void setBand (int band, float frequency, float gainDecibels, float q) noexcept;
+
+    void process (juce::AudioBuffer<float>& block) noexcept;
+
+    /** The number of bands currently running in the cascade. */
+    int getNumActiveBands() const noexcept      { return numActiveBands; }
+
+private:
+    //==============================================================================
+    struct Band
+    {
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> frequency { 1000.0f };
+        juce::SmoothedValue<float> gain { 0.0f };
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> q { 0.707f };
+
+        bool isSmoothing() const noexcept       { return frequency.isSmoothing() || gain.isSmoothing() || q.isSmoothing(); }
+        bool isActive() const noexcept          { return isSmoothing() || std::abs (gain.getTargetValue()) > 1.0e-3f; }
+    };
+
+    /** Advances the smoothers by numSamples and rebuilds the cascades' coefficients. */
+    void updateCoefficients (int numSamples) noexcept;
+    void processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept;
+
+    Band bands[numBands];                           /**< Band i runs in stage i of every cascade. */
+    int numActiveBands = 0;
+    bool needsUpdate = true;
+
+    std::vector<BiquadCascade> groups;              /**< One per lanes channels. */
+    std::vector<BiquadCascade::Vec> interleaved;    /**< Scratch, one register per sample. */
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+};
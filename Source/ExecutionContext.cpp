@@ -0,0 +1,115 @@
+#include "ExecutionContext.h"
+
+//==============================================================================
+std::vector<ExecutionContext::ThreadStats> ExecutionContext::getStats() const
+{
+    const juce::ScopedLock sl (lock);
+    std::vector<ThreadStats> stats;
+    stats.reserve ((size_t) numSlots);
+
+    for (int i = 0; i < numSlots; ++i)
+        stats.push_back (readSlot (slots[(size_t) i]));
+
+    return stats;
+}
+
+ExecutionContext::ThreadStats ExecutionContext::readSlot (const Slot& slot)
+{
+    ThreadStats s;
+    s.name = slot.name;
+    s.role = slot.role;
+    s.running = slot.running;
+    s.cycles = slot.cycles.load (std::memory_order_relaxed);
+    s.busySeconds = juce::Time::highResolutionTicksToSeconds (slot.busyTicks.load (std::memory_order_relaxed));
+    s.longestCycleSeconds = juce::Time::highResolutionTicksToSeconds (slot.longestCycleTicks.load (std::memory_order_relaxed));
+    s.denormalsDisabled = slot.denormalsDisabled.load (std::memory_order_relaxed);
+    return s;
+}
+
+//==============================================================================
+int ExecutionContext::registerThread (const juce::String& name, Role role)
+{
+    const juce::ScopedLock sl (lock);
+
+    // A restarted thread carries on with its earlier stats
+    for (int i = 0; i < numSlots; ++i)
+    {
+        auto& slot = slots[(size_t) i];
+
+        if (! slot.running && slot.role == role && slot.name == name)
+        {
+            slot.running = true;
+            return i;
+        }
+    }
+
+    if (numSlots == maxThreads)
+        return -1;
+
+    auto& slot = slots[(size_t) numSlots];
+    slot.name = name;
+    slot.role = role;
+    slot.running = true;
+    return numSlots++;
+}
+
+void ExecutionContext::unregisterThread (int slotIndex)
+{
+    const juce::ScopedLock sl (lock);
+    slots[(size_t) slotIndex].running = false;
+}
+
+//==============================================================================
+ExecutionContext::ThreadScope::ThreadScope (const juce::String& name, Role r)
+    : role (r),
+      slotIndex (r == Role::audio ? -1 : context->registerThread (name, r)),
+      ownSlot (r == Role::audio ? std::make_unique<Slot>() : nullptr),
+      slot (ownSlot != nullptr ? ownSlot.get() : slotIndex >= 0 ? &context->slots[(size_t) slotIndex] : nullptr)
+{
+    if (ownSlot != nullptr)
+    {
+        ownSlot->name = name;
+        ownSlot->role = role;
+        ownSlot->running = true;
+    }
+}
+
+ExecutionContext::ThreadScope::~ThreadScope()
+{
+    if (slotIndex >= 0)
+        context->unregisterThread (slotIndex);
+}
+
+ExecutionContext::ThreadStats ExecutionContext::ThreadScope::getStats() const
+{
+    if (ownSlot != nullptr)
+        return readSlot (*ownSlot);
+
+    // A registered slot's name and running flag change under the lock
+    const juce::ScopedLock sl (context->lock);
+    return slot != nullptr ? readSlot (*slot) : ThreadStats {};
+}
+
+//==============================================================================
+ExecutionContext::ScopedCycle::ScopedCycle (ThreadScope& s) noexcept
+    : scope (s), startTicks (juce::Time::getHighResolutionTicks())
+{
+}
+
+ExecutionContext::ScopedCycle::~ScopedCycle() noexcept
+{
+    if (scope.slot == nullptr)
+        return;
+
+    auto& slot = *scope.slot;
+    const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+
+    // Only this thread writes its slot, so plain loads and stores are enough
+    slot.cycles.store (slot.cycles.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.busyTicks.store (slot.busyTicks.load (std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+
+    if (ticks > slot.longestCycleTicks.load (std::memory_order_relaxed))
+        slot.longestCycleTicks.store (ticks, std::memory_order_relaxed);
+
+    slot.denormalsDisabled.store (juce::FloatVectorOperations::areDenormalsDisabled(), std::memory_order_relaxed);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+
+/**
+    The execution context of every thread that runs our DSP or feeds it:
+    the host's audio thread inside processBlock(), and our own workers (the
+    sample streamer, the spectrum analyser and the asset loaders).
+
+    Each thread registers a ThreadScope for as long as it runs, and wraps
+    each unit of work in a ScopedCycle. A ScopedCycle:
+    - flushes denormals to zero (FTZ/DAZ), so filter and reverb tails that
+      decay into the denormal range cost nothing extra on any thread;
+    - times the work for getStats().
+
+    None of the workers joins the host's audio workgroup. Only threads whose
+    work the audio thread waits for, every cycle, belong in it, and none of
+    ours does that. The streamer blocks on the disk, and the others are
+    background work that the audio thread only ever reads from lock-free. So
+    they keep their own lower priorities and can't hold up the audio thread.
+
+    One instance is shared by every plugin instance in the process. Threads
+    reach it through ThreadScope; anything else holds it through a
+    juce::SharedResourcePointer<ExecutionContext>.
+*/
+class ExecutionContext
+{
+public:
+    //==============================================================================
+    enum class Role
+    {
+        audio,          /**< The host's audio thread, inside processBlock(). */
+        worker          /**< Everything else: streaming, loading, analysis. */
+    };
+
+    struct ThreadStats
+    {
+        juce::String name;
+        Role role = Role::worker;
+        bool running = false;               /**< False once its ThreadScope has gone. */
+        juce::uint64 cycles = 0;
+        double busySeconds = 0.0;           /**< Summed over every cycle. */
+        double longestCycleSeconds = 0.0;
+        bool denormalsDisabled = false;     /**< As of the most recent cycle. */
+    };
+
+    /** Worker threads past this many still get FTZ/DAZ, just no stats. Role::audio scopes don't count. */
+    static constexpr int maxThreads = 64;
+
+    //==============================================================================
+    ExecutionContext() = default;
+
+    /** Not for the audio thread: every registered worker, including those that have stopped. */
+    std::vector<ThreadStats> getStats() const;
+
+private:
+    struct Slot;
+
+public:
+    //==============================================================================
+    class ScopedCycle;
+
+    /**
+        A thread's registration, normally on the stack of its run() so that it
+        lives exactly as long as the thread.
+
+        The processor registers the host's audio thread, which it doesn't own,
+        as a member with Role::audio. A host can load any number of instances,
+        so those scopes keep their stats to themselves rather than taking a
+        slot each; read them with getStats(). Any thread may create it.
+    */
+    class ThreadScope
+    {
+    public:
+        ThreadScope (const juce::String& name, Role role);
+        ~ThreadScope();
+
+        /** Not for the audio thread: this thread's stats, from its slot or its own. */
+        ThreadStats getStats() const;
+
+    private:
+        friend class ScopedCycle;
+
+        juce::SharedResourcePointer<ExecutionContext> context;
+        const Role role;
+        const int slotIndex;                /**< -1 for Role::audio, or when every slot was taken. */
+        std::unique_ptr<Slot> ownSlot;      /**< Role::audio's stats, outside the shared table. */
+        Slot* const slot;                   /**< ownSlot, the registered slot, or nullptr. */
+
+        JUCE_DECLARE_NON_COPYABLE (ThreadScope)
+    };
+
+    /**
+        One unit of a thread's work: a block on the audio thread, a job or a
+        pass over the voices on a worker. Realtime safe.
+    */
+    class ScopedCycle
+    {
+    public:
+        explicit ScopedCycle (ThreadScope& scope) noexcept;
+        ~ScopedCycle() noexcept;
+
+    private:
+        ThreadScope& scope;
+        juce::ScopedNoDenormals noDenormals;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCycle)
+    };
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        juce::String name;                  /**< Set under the lock. */
+        Role role = Role::worker;
+        bool running = false;               /**< Under the lock. */
+        std::atomic<juce::uint64> cycles { 0 };
+        std::atomic<juce::int64> busyTicks { 0 };
+        std::atomic<juce::int64> longestCycleTicks { 0 };
+        std::atomic<bool> denormalsDisabled { false };
+    };
+
+    static ThreadStats readSlot (const Slot& slot);
+    int registerThread (const juce::String& name, Role role);
+    void unregisterThread (int slotIndex);
+
+    juce::CriticalSection lock;
+    std::array<Slot, maxThreads> slots;
+    int numSlots = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ExecutionContext)
+};
@@ -0,0 +1,33 @@
+#include "FftPlanCache.h"
+
+//==============================================================================
+FftPlanCache::Plan::Plan (int order)
+    : fft (order), window ((size_t) fft.getSize())
+{
+    // Periodic rather than symmetric, so overlapping frames sum to a constant
+    const auto size = fft.getSize();
+
+    for (int i = 0; i < size; ++i)
+        window[(size_t) i] = 0.5f - 0.5f * std::cos (juce::MathConstants<float>::twoPi * (float) i / (float) size);
+
+    for (auto w : window)
+        windowSum += w;
+}
+
+//==============================================================================
+const FftPlanCache::Plan& FftPlanCache::getPlan (int order)
+{
+    const juce::ScopedLock sl (lock);
+    auto& plan = plans[order];
+
+    if (plan == nullptr)
+        plan = std::make_unique<Plan> (order);
+
+    return *plan;
+}
+
+int FftPlanCache::getNumPlans() const
+{
+    const juce::ScopedLock sl (lock);
+    return (int) plans.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <map>
+
+/**
+    FFT plans and their analysis windows, built once per size and shared by
+    every analyser in the process.
+
+    Hold one through a juce::SharedResourcePointer<FftPlanCache>: the cache
+    lives as long as any plugin instance does, so opening a second editor or
+    a second instance reuses the tables instead of rebuilding them. Plans
+    are never removed, so a reference from getPlan() stays valid for the
+    holder's lifetime. juce::dsp::FFT's transforms are const and safe to run
+    on several threads at once.
+*/
+class FftPlanCache
+{
+public:
+    //==============================================================================
+    struct Plan
+    {
+        explicit Plan (int order);
+
+        juce::dsp::FFT fft;
+        std::vector<float> window;  /**< A periodic Hann window of fft.getSize() points. */
+        float windowSum = 0.0f;     /**< Scales a windowed bin back to the sine amplitude that made it. */
+    };
+
+    //==============================================================================
+    /** Returns the plan for 2^order points, creating it on first use. Not for the audio thread. */
+    const Plan& getPlan (int order);
+
+    int getNumPlans() const;
+
+private:
+    //==============================================================================
+    juce::CriticalSection lock;
+    std::map<int, std::unique_ptr<Plan>> plans;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+    Runs a block of DSP in a fixed processing quantum, whatever block sizes
+    the host sends.
+
+    There are two ways to get there:
+    - fifo: host audio goes through an input FIFO, every full quantum is
+      processed, and the result comes back out of an output FIFO one quantum
+      later. The callback only ever sees exactly QuantumSize samples, and a
+      run of 1-3 sample host blocks costs a copy each rather than a whole
+      pass of the DSP. The delay is QuantumSize samples, reported by
+      getLatencySamples().
+    - split: the host block is processed in place in QuantumSize pieces
+      plus a shorter tail. No latency, but the tail still varies, and tiny
+      host blocks are processed as they come.
+
+    With a QuantumSize of 0 the adapter is inactive and the callback gets the
+    host block directly.
+*/
+template <int QuantumSize, bool UseFifo>
+class FixedBlockAdapter
+{
+public:
+    static_assert (QuantumSize >= 0, "QuantumSize must be positive, or 0 to disable the adapter");
+
+    static constexpr int quantumSize = QuantumSize;
+    static constexpr bool usesFifo = UseFifo && QuantumSize > 0;
+
+    //==============================================================================
+    void prepare (int numChannelsToUse, int maxHostBlock)
+    {
+        numChannels = numChannelsToUse;
+        maxHostBlockSize = juce::jmax (1, maxHostBlock);
+
+        if constexpr (usesFifo)
+        {
+            for (auto& buffer : quanta)
+                buffer.setSize (numChannels, QuantumSize);
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& buffer : quanta)
+            buffer.clear();
+
+        numBuffered = 0;
+        current = 0;
+    }
+
+    //==============================================================================
+    bool isActive() const noexcept                  { return QuantumSize > 0; }
+    int getLatencySamples() const noexcept          { return usesFifo ? QuantumSize : 0; }
+
+    /** The largest block the callback will be given. */
+    int getMaxProcessingBlockSize() const noexcept
+    {
+        if constexpr (QuantumSize == 0)
+            return maxHostBlockSize;
+        else
+            return usesFifo ? QuantumSize : juce::jmin (QuantumSize, maxHostBlockSize);
+    }
+
+    /**
+        Host samples sitting in the input FIFO. The first quantum processed in
+        the next process() call starts this many samples before its block.
+    */
+    int getNumBuffered() const noexcept             { return numBuffered; }
+
+    //==============================================================================
+    /** Calls processQuantum (juce::AudioBuffer<float>&) for every quantum that's ready. */
+    template <typename ProcessQuantum>
+    void process (juce::AudioBuffer<float>& hostBlock, ProcessQuantum&& processQuantum)
+    {
+        const auto numSamples = hostBlock.getNumSamples();
+
+        if constexpr (QuantumSize == 0)
+        {
+            processQuantum (hostBlock);
+        }
+        else if constexpr (usesFifo)
+        {
+            for (int start = 0; start < numSamples;)
+            {
+                const auto num = juce::jmin (numSamples - start, QuantumSize - numBuffered);
+                auto& input = quanta[current];
+                auto& output = quanta[1 - current];
+
+                // The output quantum is the previous input, so sample i comes out QuantumSize later
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    input.copyFrom (ch, numBuffered, hostBlock, ch, start, num);
+                    hostBlock.copyFrom (ch, start, output, ch, numBuffered, num);
+                }
+
+                numBuffered += num;
+                start += num;
+
+                if (numBuffered == QuantumSize)
+                {
+                    processQuantum (input);
+                    current = 1 - current;
+                    numBuffered = 0;
+                }
+            }
+        }
+        else
+        {
+            for (int start = 0; start < numSamples; start += QuantumSize)
+            {
+                juce::AudioBuffer<float> quantum (hostBlock.getArrayOfWritePointers(), numChannels, start,
+                                                  juce::jmin (QuantumSize, numSamples - start));
+                processQuantum (quantum);
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    juce::AudioBuffer<float> quanta[2];     /**< FIFO only: the quantum being filled, and the processed one being emptied. */
+    int current = 0;                        /**< Which of quanta is being filled. */
+    int numBuffered = 0;
+    int numChannels = 0;
+    int maxHostBlockSize = 0;
+};
@@ -0,0 +1,14 @@
+#include "PluginProcessor.h"
+
+//==============================================================================
+// The headless runtime's side of the editor: render nodes, tools and the
+// headless tests have no GUI, so the processor never offers one there
+juce::AudioProcessorEditor* VstTestPlaygroundAudioProcessor::createEditor()
+{
+    return nullptr;
+}
+
+bool VstTestPlaygroundAudioProcessor::hasEditor() const
+{
+    return false;
+}
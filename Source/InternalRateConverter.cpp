@@ -0,0 +1,95 @@
+#include "InternalRateConverter.h"
+
+//==============================================================================
+void InternalRateConverter::prepare (double hostRate, double internalRate, int numChannelsToUse, int maxHostBlock)
+{
+    numChannels = numChannelsToUse;
+    maxHostBlockSize = juce::jmax (1, maxHostBlock);
+    active = internalRate > 0.0 && std::abs (internalRate - hostRate) > 1.0e-6;
+    processingRate = active ? internalRate : hostRate;
+
+    if (! active)
+    {
+        maxProcessingBlockSize = maxHostBlockSize;
+        latencySamples = 0;
+        return;
+    }
+
+    inputResampler.prepare (hostRate, internalRate, numChannels, maxHostBlockSize);
+    maxProcessingBlockSize = inputResampler.getMaxOutputSamples (maxHostBlockSize);
+    outputResampler.prepare (internalRate, hostRate, numChannels, maxProcessingBlockSize);
+
+    // Both filters need numTaps samples of look-ahead before they produce
+    // anything, so the output side starts that far behind (plus rounding slack).
+    const auto hostPerInternal = inputResampler.getStep();
+    const auto taps = (double) PolyphaseResampler::numTaps;
+    prefillSamples = (int) std::ceil (taps + taps * hostPerInternal) + 3;
+
+    // Output sample k represents host input time
+    //   k - prefill + centreOffset * (1 + hostPerInternal) + initialPosition,
+    // so the delay is made whole by starting the input filter slightly late.
+    const auto rawLatency = prefillSamples - PolyphaseResampler::getCentreOffset() * (1.0 + hostPerInternal);
+    latencySamples = (int) std::floor (rawLatency);
+    initialPosition = rawLatency - latencySamples;
+
+    internalBuffer.setSize (numChannels, maxProcessingBlockSize);
+    pending.setSize (numChannels, prefillSamples + outputResampler.getMaxOutputSamples (maxProcessingBlockSize) + maxHostBlockSize);
+    readPointers.allocate ((size_t) numChannels, true);
+    writePointers.allocate ((size_t) numChannels, true);
+
+    reset();
+}
+
+void InternalRateConverter::reset()
+{
+    if (! active)
+        return;
+
+    inputResampler.reset (initialPosition);
+    outputResampler.reset();
+
+    pending.clear();
+    numPending = prefillSamples;
+}
+
+//==============================================================================
+juce::AudioBuffer<float> InternalRateConverter::toInternalRate (const juce::AudioBuffer<float>& hostBlock, int start, int num) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        readPointers[ch] = hostBlock.getReadPointer (ch, start);
+
+    const auto numInternal = inputResampler.process (readPointers, num, internalBuffer.getArrayOfWritePointers(),
+                                                     internalBuffer.getNumSamples());
+
+    return juce::AudioBuffer<float> (internalBuffer.getArrayOfWritePointers(), numChannels, numInternal);
+}
+
+void InternalRateConverter::fromInternalRate (const juce::AudioBuffer<float>& internalBlock, juce::AudioBuffer<float>& hostBlock,
+                                              int start, int num) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        readPointers[ch] = internalBlock.getReadPointer (ch);
+        writePointers[ch] = pending.getWritePointer (ch, numPending);
+    }
+
+    numPending += outputResampler.process (readPointers, internalBlock.getNumSamples(), writePointers,
+                                           pending.getNumSamples() - numPending);
+
+    // The prefill guarantees a full block is always ready
+    jassert (numPending >= num);
+    const auto numToCopy = juce::jmin (num, numPending);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = pending.getWritePointer (ch);
+        hostBlock.copyFrom (ch, start, data, numToCopy);
+
+        if (numToCopy < num)
+            hostBlock.clear (ch, start + numToCopy, num - numToCopy);
+
+        std::memmove (data, data + numToCopy, sizeof (float) * (size_t) (numPending - numToCopy));
+    }
+
+    numPending -= numToCopy;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "PolyphaseResampler.h"
+
+/**
+    Runs a block of DSP at a fixed internal sample rate, whatever the host rate.
+
+    Host audio is resampled to the internal rate, handed to a callback, and
+    resampled back. The output side goes through a small FIFO pre-filled with
+    silence, so every host block is filled completely even though the number
+    of internal samples per block varies. The resulting delay is whole samples
+    and is reported by getLatencySamples().
+
+    When the host already runs at the internal rate the converter is inactive
+    and the callback gets the host buffer directly.
+*/
+class InternalRateConverter
+{
+public:
+    //==============================================================================
+    /** Pass internalRate <= 0 to disable conversion. */
+    void prepare (double hostRate, double internalRate, int numChannels, int maxHostBlockSize);
+    void reset();
+
+    //==============================================================================
+    bool isActive() const noexcept                  { return active; }
+    int getLatencySamples() const noexcept          { return active ? latencySamples : 0; }
+
+    /** The rate the callback's DSP should be prepared for. */
+    double getProcessingRate() const noexcept       { return processingRate; }
+
+    /** The largest block the callback will be given. */
+    int getMaxProcessingBlockSize() const noexcept  { return maxProcessingBlockSize; }
+
+    //==============================================================================
+    /** Calls processInternal (juce::AudioBuffer<float>&) with the block at the internal rate. */
+    template <typename ProcessInternal>
+    void process (juce::AudioBuffer<float>& hostBlock, ProcessInternal&& processInternal)
+    {
+        if (! active)
+        {
+            processInternal (hostBlock);
+            return;
+        }
+
+        // Hosts may exceed the block size they promised; convert in chunks
+        for (int start = 0; start < hostBlock.getNumSamples(); start += maxHostBlockSize)
+        {
+            const auto num = juce::jmin (maxHostBlockSize, hostBlock.getNumSamples() - start);
+            auto internalBlock = toInternalRate (hostBlock, start, num);
+            processInternal (internalBlock);
+            fromInternalRate (internalBlock, hostBlock, start, num);
+        }
+    }
+
+private:
+    //==============================================================================
+    juce::AudioBuffer<float> toInternalRate (const juce::AudioBuffer<float>& hostBlock, int start, int num) noexcept;
+    void fromInternalRate (const juce::AudioBuffer<float>& internalBlock, juce::AudioBuffer<float>& hostBlock, int start, int num) noexcept;
+
+    PolyphaseResampler inputResampler;      /**< Host rate to internal rate. */
+    PolyphaseResampler outputResampler;     /**< Internal rate back to host rate. */
+
+    juce::AudioBuffer<float> internalBuffer;
+    juce::AudioBuffer<float> pending;       /**< Host-rate output waiting to be delivered. */
+    int numPending = 0;
+    int prefillSamples = 0;
+    double initialPosition = 0.0;
+
+    juce::HeapBlock<const float*> readPointers;
+    juce::HeapBlock<float*> writePointers;
+
+    bool active = false;
+    int numChannels = 0;
+    int maxHostBlockSize = 0;
+    int maxProcessingBlockSize = 0;
+    int latencySamples = 0;
+    double processingRate = 0.0;
+};
@@ -0,0 +1,179 @@
+#include "LookaheadLimiter.h"
+#include "ChannelKernels.h"
+
+namespace
+{
+    constexpr int maxChunkSize = 256;
+}
+
+//==============================================================================
+void LookaheadLimiter::prepare (double newSampleRate, int maxBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+
+    // Gains fade over lookaheadSamples + 1 frames, and land on the frame lookaheadSamples later
+    lookaheadSamples = juce::jmax (1, juce::roundToInt (lookaheadMs * sampleRate / 1000.0));
+    windowPeak.setWindowSize (lookaheadSamples + 1);
+    averageHistory.resize ((size_t) lookaheadSamples + 1);
+
+    interpolatorHistory.setSize (numChannels, 2 * interpolatorTaps);
+    delayLine.setSize (numChannels, getLatencySamples());
+    designInterpolator();
+
+    chunkSize = juce::jlimit (1, maxChunkSize, maxBlockSize);
+    peaks.allocate ((size_t) chunkSize, true);
+    gains.allocate ((size_t) chunkSize, true);
+
+    releaseCoefficient = 0.0f;  // force setRelease() to recompute for the new rate
+    setRelease (releaseMs);
+    wetMixStep = (float) (1000.0 / (bypassFadeMilliseconds * sampleRate));
+    reset();
+}
+
+void LookaheadLimiter::reset()
+{
+    interpolatorHistory.clear();
+    delayLine.clear();
+    historyPosition = 0;
+    delayPosition = 0;
+
+    windowPeak.reset();
+    std::fill (averageHistory.begin(), averageHistory.end(), 1.0f);
+    averageSum = (double) averageHistory.size();
+    averagePosition = 0;
+
+    gain = 1.0f;
+    wetMix = enabled ? 1.0f : 0.0f;
+    gainReduction.store (0.0f, std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::setRelease (float newReleaseMs) noexcept
+{
+    if (juce::approximatelyEqual (releaseMs, newReleaseMs) && releaseCoefficient != 0.0f)
+        return;
+
+    releaseMs = newReleaseMs;
+    releaseCoefficient = (float) std::exp (-1000.0 / (juce::jmax (1.0f, releaseMs) * sampleRate));
+}
+
+void LookaheadLimiter::designInterpolator() noexcept
+{
+    // Hann-windowed sinc phases at 1/4, 2/4 and 3/4 of a sample after the input
+    // interpolatorDelay samples back; the 0 phase is that input itself
+    constexpr auto pi = juce::MathConstants<double>::pi;
+
+    for (int p = 1; p < oversampling; ++p)
+    {
+        auto& phase = phaseCoefficients[p - 1];
+        auto sum = 0.0;
+
+        for (int k = 0; k < interpolatorTaps; ++k)
+        {
+            const auto distance = (double) (interpolatorTaps - 1 - k - interpolatorDelay) + (double) p / oversampling;
+            const auto fromCentre = (double) k - 0.5 * (interpolatorTaps - 1);
+            const auto window = 0.5 + 0.5 * std::cos (pi * fromCentre / (0.5 * interpolatorTaps));
+
+            phase[k] = (float) (window * std::sin (pi * distance) / (pi * distance));
+            sum += phase[k];
+        }
+
+        // Unity gain at DC, so a constant never reads as a peak
+        for (auto& c : phase)
+            c = (float) (c / sum);
+    }
+}
+
+//==============================================================================
+void LookaheadLimiter::process (juce::AudioBuffer<float>& block) noexcept
+{
+    for (int start = 0; start < block.getNumSamples(); start += chunkSize)
+        processChunk (block, start, juce::jmin (chunkSize, block.getNumSamples() - start));
+
+    const auto applied = 1.0f + wetMix * (gain - 1.0f);
+    gainReduction.store (-juce::Decibels::gainToDecibels (applied, -120.0f), std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept
+{
+    const auto channels = juce::jmin (numChannels, block.getNumChannels());
+    const auto delayLength = delayLine.getNumSamples();
+
+    // Linked true-peak detection, and the delay
+    juce::FloatVectorOperations::clear (peaks, num);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        auto* data = block.getWritePointer (ch, start);
+        auto* history = interpolatorHistory.getWritePointer (ch);
+        auto* delayed = delayLine.getWritePointer (ch);
+        auto hp = historyPosition;
+        auto dp = delayPosition;
+
+        for (int i = 0; i < num; ++i)
+        {
+            const auto x = data[i];
+            history[hp] = history[hp + interpolatorTaps] = x;
+            hp = hp + 1 == interpolatorTaps ? 0 : hp + 1;
+
+            // The taps now run from oldest to newest starting at hp
+            const auto* taps = history + hp;
+            auto peak = std::abs (taps[interpolatorTaps - 1 - interpolatorDelay]);
+
+            for (const auto& phase : phaseCoefficients)
+            {
+                auto value = 0.0f;
+
+                for (int k = 0; k < interpolatorTaps; ++k)
+                    value += taps[k] * phase[k];
+
+                peak = juce::jmax (peak, std::abs (value));
+            }
+
+            peaks[i] = juce::jmax (peaks[i], peak);
+
+            data[i] = delayed[dp];
+            delayed[dp] = x;
+            dp = dp + 1 == delayLength ? 0 : dp + 1;
+        }
+    }
+
+    historyPosition = (historyPosition + num) % interpolatorTaps;
+    delayPosition = (delayPosition + num) % delayLength;
+
+    // Every value in the average is at most the gain the delayed frame needs, so the average is too
+    const auto windowSize = (double) averageHistory.size();
+    const auto wetTarget = enabled ? 1.0f : 0.0f;
+    auto lowestGain = 1.0f;
+
+    for (int i = 0; i < num; ++i)
+    {
+        const auto peak = windowPeak.push (peaks[i]);
+        const auto target = peak > ceiling ? ceiling / peak : 1.0f;
+
+        averageSum += target - averageHistory[(size_t) averagePosition];
+        averageHistory[(size_t) averagePosition] = target;
+        averagePosition = averagePosition + 1 == (int) averageHistory.size() ? 0 : averagePosition + 1;
+
+        const auto faded = (float) (averageSum / windowSize);
+        gain = faded < gain ? faded : faded + (gain - faded) * releaseCoefficient;
+
+        // Switching on or off crossfades between the limited and the bypassed gain
+        if (wetMix != wetTarget)
+            wetMix = enabled ? juce::jmin (1.0f, wetMix + wetMixStep) : juce::jmax (0.0f, wetMix - wetMixStep);
+
+        gains[i] = 1.0f + wetMix * (gain - 1.0f);
+        lowestGain = juce::jmin (lowestGain, gains[i]);
+    }
+
+    // Nothing to do below the ceiling, and skipping keeps the output bit-exact
+    if (lowestGain >= 1.0f)
+        return;
+
+    juce::AudioBuffer<float> chunk (block.getArrayOfWritePointers(), channels, start, num);
+
+    ChannelKernels::dispatch (channels, [&] (auto channelCount)
+    {
+        ChannelKernels::applyGainRamp<decltype (channelCount)::value> (chunk.getArrayOfWritePointers(), channels, gains, num);
+    });
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SlidingMaximum.h"
+
+/**
+    A true-peak brickwall limiter with lookahead, for the end of the chain.
+
+    Peaks between samples count too: each channel runs through a 4x polyphase
+    interpolator (a windowed sinc, interpolatorTaps taps per phase), and the
+    loudest sample or in-between value of any channel is the frame's peak.
+    A SlidingMaximum over the lookahead gives the deepest gain any sample in
+    the window needs. A moving average of that over the same window fades
+    the gain down across the lookahead, so it is low enough when the peak
+    arrives and never overshoots the ceiling. Release is exponential. The
+    audio is delayed to line up with the gain, and getLatencySamples()
+    reports by how much.
+
+    Switching it off only bypasses the gain, with a short crossfade. The
+    detection and the delay keep running, so the latency never changes and
+    switching back on limits straight away.
+
+    Every step costs the same per sample whatever the lookahead, and the gain
+    goes on through the ChannelKernels ramp kernels.
+*/
+class LookaheadLimiter
+{
+public:
+    //==============================================================================
+    static constexpr int oversampling = 4;
+    static constexpr int interpolatorTaps = 16;
+    static constexpr float bypassFadeMilliseconds = 5.0f;
+
+    //==============================================================================
+    void prepare (double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+
+    /** Fades the gain in or out over bypassFadeMilliseconds. */
+    void setEnabled (bool shouldBeEnabled) noexcept     { enabled = shouldBeEnabled; }
+    void setCeiling (float decibels) noexcept           { ceiling = juce::Decibels::decibelsToGain (decibels); }
+    void setRelease (float milliseconds) noexcept;
+
+    /** The lookahead, 1.5 ms by default. It changes the latency, so it takes effect on the next prepare(). */
+    void setLookahead (float milliseconds) noexcept     { lookaheadMs = milliseconds; }
+
+    /** The delay process() adds, enabled or not, in samples at the prepared rate. */
+    int getLatencySamples() const noexcept              { return lookaheadSamples + interpolatorDelay; }
+
+    void process (juce::AudioBuffer<float>& block) noexcept;
+
+    /** The most recent gain reduction, in positive dB. Safe to read from any thread. */
+    float getGainReductionDecibels() const noexcept     { return gainReduction.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    /** The interpolator's phases follow this many samples behind the newest input. */
+    static constexpr int interpolatorDelay = interpolatorTaps / 2 - 1;
+
+    void designInterpolator() noexcept;
+    void processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept;
+
+    float phaseCoefficients[oversampling - 1][interpolatorTaps] {};  /**< The phases between samples, oldest tap first. */
+    juce::AudioBuffer<float> interpolatorHistory;   /**< The last interpolatorTaps inputs per channel, twice over so the taps are contiguous. */
+    juce::AudioBuffer<float> delayLine;             /**< getLatencySamples() long, circular. */
+    int historyPosition = 0;
+    int delayPosition = 0;
+
+    SlidingMaximum windowPeak;
+    std::vector<float> averageHistory;              /**< The last window's target gains, circular. */
+    double averageSum = 0.0;
+    int averagePosition = 0;
+
+    juce::HeapBlock<float> peaks, gains;
+    int chunkSize = 0;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    float lookaheadMs = 1.5f;
+    int lookaheadSamples = 0;
+    float ceiling = 1.0f;
+    float releaseMs = 100.0f;
+    float releaseCoefficient = 0.0f;
+    float gain = 1.0f;                              /**< The limiting gain, tracked whether enabled or not. */
+    float wetMix = 0.0f;                            /**< How much of that gain is applied: 0 bypassed, 1 enabled. */
+    float wetMixStep = 1.0f;
+    bool enabled = false;
+    std::atomic<float> gainReduction { 0.0f };
+};
@@ -0,0 +1,362 @@
+#include "MpeVoicePool.h"
+#include "ContentHash.h"
+
+namespace
+{
+    constexpr float voiceGain = 0.25f;
+    constexpr float maxPhaseIncrement = 0.45f;
+    constexpr float maxDriftCents = 8.0f;
+    constexpr double stealFadeSeconds = 0.003;
+
+    /** The zone whose master channel this is, or nullptr. */
+    const juce::MPEZoneLayout::Zone* findZoneForMaster (const juce::MPEZoneLayout::Zone& lower,
+                                                        const juce::MPEZoneLayout::Zone& upper,
+                                                        int channel) noexcept
+    {
+        if (lower.isActive() && lower.getMasterChannel() == channel)
+            return &lower;
+
+        if (upper.isActive() && upper.getMasterChannel() == channel)
+            return &upper;
+
+        return nullptr;
+    }
+}
+
+//==============================================================================
+void MpeVoicePool::prepare (double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    scratchSize = juce::jmax (1, maxBlockSize);
+    scratch.allocate ((size_t) scratchSize, true);
+
+    smoothing = (float) (1.0 - std::exp (-controlInterval / (0.005 * sampleRate)));
+    attackPerSample = (float) (1.0 / (0.005 * sampleRate));
+    releasePerSample = (float) (1.0 / (0.05 * sampleRate));
+    stealFadePerSample = (float) (1.0 / (stealFadeSeconds * sampleRate));
+
+    reset();
+}
+
+void MpeVoicePool::reset() noexcept
+{
+    for (auto& lane : lanes)
+        lane = {};
+
+    for (auto& channel : channelState)
+        std::fill (std::begin (channel), std::end (channel), 0.0f);
+
+    std::fill (std::begin (active), std::end (active), false);
+    std::fill (std::begin (released), std::end (released), false);
+    std::fill (std::begin (stolen), std::end (stolen), false);
+    std::fill (std::begin (amplitude), std::end (amplitude), 0.0f);
+    std::fill (std::begin (envelope), std::end (envelope), 0.0f);
+
+    samplesUntilControl = 0;
+    nextStartOrder = 0;
+}
+
+//==============================================================================
+void MpeVoicePool::handleEvent (const PreparsedMidiBuffer::Event& event, const juce::MPEZoneLayout& zones) noexcept
+{
+    using Type = PreparsedMidiBuffer::Event::Type;
+
+    const auto channel = (int) event.channel;
+    const auto lower = zones.getLowerZone();
+    const auto upper = zones.getUpperZone();
+
+    // Writes a channel-wide value into the targets of every voice on that channel
+    auto setChannelLane = [this, channel] (Lane lane, float value)
+    {
+        channelState[lane][channel - 1] = value;
+
+        for (int v = 0; v < maxVoices; ++v)
+            lanes[lane].target[v] = midiChannel[v] == channel ? value : lanes[lane].target[v];
+    };
+
+    switch (event.type)
+    {
+        case Type::noteOn:
+            startVoice (event, zones);
+            break;
+
+        case Type::noteOff:
+            if (const auto v = findVoice (channel, event.note); v >= 0)
+                released[v] = true;
+            break;
+
+        case Type::pitchBend:
+            if (const auto* zone = event.perNote ? nullptr : findZoneForMaster (lower, upper, channel))
+            {
+                channelState[masterBend][channel - 1] = event.semitones;
+
+                for (int v = 0; v < maxVoices; ++v)
+                    if (zone->isUsingChannelAsMemberChannel (midiChannel[v]))
+                        lanes[masterBend].target[v] = event.semitones;
+            }
+            else
+            {
+                setChannelLane (noteBend, event.semitones);
+            }
+            break;
+
+        case Type::channelPressure:
+            setChannelLane (pressure, event.normalised);
+            break;
+
+        case Type::polyPressure:
+            if (const auto v = findVoice (channel, event.note); v >= 0)
+                lanes[pressure].target[v] = event.normalised;
+            break;
+
+        case Type::controller:
+            if (event.number == 74)
+                setChannelLane (timbre, event.normalised);
+            break;
+
+        case Type::allNotesOff:
+        {
+            const auto* zone = findZoneForMaster (lower, upper, channel);
+
+            for (int v = 0; v < maxVoices; ++v)
+            {
+                if (getChannel (v) == channel || (zone != nullptr && zone->isUsingChannelAsMemberChannel (getChannel (v))))
+                {
+                    released[v] = true;
+
+                    // All sound off doesn't wait for the release, or for a stolen note's fade
+                    if (event.number == 120)
+                        active[v] = stolen[v] = false;
+                }
+            }
+            break;
+        }
+
+        case Type::parameter:
+        case Type::programChange:
+        default:
+            break;
+    }
+}
+
+void MpeVoicePool::startVoice (const PreparsedMidiBuffer::Event& event, const juce::MPEZoneLayout& zones) noexcept
+{
+    // A free voice if there is one, otherwise the oldest
+    int voice = 0;
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if (! active[v])
+        {
+            voice = v;
+            break;
+        }
+
+        if (nextStartOrder - startOrder[v] > nextStartOrder - startOrder[voice])
+            voice = v;
+    }
+
+    const auto channel = (int) event.channel;
+    const auto lower = zones.getLowerZone();
+    const auto upper = zones.getUpperZone();
+    const auto master = lower.isUsingChannelAsMemberChannel (channel) ? lower.getMasterChannel()
+                      : upper.isUsingChannelAsMemberChannel (channel) ? upper.getMasterChannel()
+                      : 0;
+
+    // Taken now, so the next steal picks another voice and the note's ID doesn't depend on the fade
+    startOrder[voice] = nextStartOrder++;
+    released[voice] = false;
+
+    if (active[voice])
+    {
+        // Fades the stolen note out first; the new one starts on the control tick where it reaches silence
+        stolen[voice] = true;
+        pendingNote[voice] = event;
+        pendingMaster[voice] = (juce::uint8) master;
+        updateVoiceControl (voice, samplesUntilControl > 0 ? samplesUntilControl : controlInterval);
+        return;
+    }
+
+    playNote (voice, event, master);
+
+    // Sound from the event onwards, without waiting for the next control tick
+    updateVoiceControl (voice, samplesUntilControl > 0 ? samplesUntilControl : controlInterval);
+}
+
+void MpeVoicePool::playNote (int voice, const PreparsedMidiBuffer::Event& event, int master) noexcept
+{
+    const auto channel = (int) event.channel;
+
+    active[voice] = true;
+    stolen[voice] = false;
+    noteNumber[voice] = event.note;
+    midiChannel[voice] = event.channel;
+    velocity[voice] = event.normalised;
+    phase[voice] = 0.0f;
+    detune[voice] = 1.0f;
+
+    if (drift > 0.0f)
+    {
+        float detuneRandom, phaseRandom;
+
+        if (driftSeed.has_value())
+        {
+            // The note's ID: the same performance gives every note the same values again
+            const auto noteId = ((juce::uint64) startOrder[voice] << 16) | ((juce::uint64) channel << 8) | event.note;
+            juce::Random noteRandom ((juce::int64) ContentHash::mix (*driftSeed ^ ContentHash::mix (noteId)));
+            detuneRandom = noteRandom.nextFloat();
+            phaseRandom = noteRandom.nextFloat();
+        }
+        else
+        {
+            detuneRandom = driftRandom.nextFloat();
+            phaseRandom = driftRandom.nextFloat();
+        }
+
+        detune[voice] = std::exp2 (drift * maxDriftCents * (2.0f * detuneRandom - 1.0f) / 1200.0f);
+        phase[voice] = drift * phaseRandom;
+    }
+
+    amplitude[voice] = 0.0f;
+    envelope[voice] = 0.0f;
+
+    // Start from the channel's current expression rather than gliding to it
+    for (int lane = 0; lane < numLanes; ++lane)
+        lanes[lane].current[voice] = lanes[lane].target[voice] = channelState[lane][channel - 1];
+
+    lanes[masterBend].current[voice] = lanes[masterBend].target[voice]
+        = master > 0 ? channelState[masterBend][master - 1] : 0.0f;
+
+    phaseIncrement[voice] = getTargetIncrement (voice);
+}
+
+//==============================================================================
+void MpeVoicePool::render (juce::AudioBuffer<float>& block, int startSample, int numSamples) noexcept
+{
+    if (getNumActiveVoices() == 0)
+        return;
+
+    while (numSamples > 0)
+    {
+        const auto num = juce::jmin (numSamples, scratchSize);
+        auto* output = scratch.get();
+        juce::FloatVectorOperations::clear (output, num);
+
+        for (int done = 0; done < num;)
+        {
+            if (samplesUntilControl == 0)
+            {
+                updateControl (controlInterval);
+                samplesUntilControl = controlInterval;
+            }
+
+            const auto n = juce::jmin (num - done, samplesUntilControl);
+            renderVoices (output + done, n);
+            done += n;
+            samplesUntilControl -= n;
+        }
+
+        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+            block.addFrom (ch, startSample, output, num, voiceGain);
+
+        startSample += num;
+        numSamples -= num;
+    }
+}
+
+void MpeVoicePool::updateControl (int numSamples) noexcept
+{
+    // Every lane of every voice, active or not: the cost doesn't depend on how much expression arrived
+    for (auto& lane : lanes)
+        for (int v = 0; v < maxVoices; ++v)
+            lane.current[v] += smoothing * (lane.target[v] - lane.current[v]);
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if (! active[v])
+            continue;
+
+        // A stolen note finished fading during the last tick, so its replacement can start
+        if (stolen[v] && envelope[v] <= 0.0f)
+            playNote (v, pendingNote[v], pendingMaster[v]);
+
+        // The release finished ramping to silence during the last tick
+        else if (released[v] && envelope[v] <= 0.0f)
+        {
+            active[v] = false;
+            continue;
+        }
+
+        updateVoiceControl (v, numSamples);
+    }
+}
+
+void MpeVoicePool::updateVoiceControl (int v, int numSamples) noexcept
+{
+    const auto increment = getTargetIncrement (v);
+
+    // Targets for the end of this tick; the render loop interpolates towards them
+    envelope[v] = stolen[v]   ? juce::jmax (0.0f, envelope[v] - stealFadePerSample * (float) numSamples)
+                : released[v] ? juce::jmax (0.0f, envelope[v] - releasePerSample * (float) numSamples)
+                              : juce::jmin (1.0f, envelope[v] + attackPerSample * (float) numSamples);
+
+    const auto level = envelope[v] * velocity[v] * (0.5f + 0.5f * lanes[pressure].current[v]);
+
+    phaseIncrementStep[v] = (increment - phaseIncrement[v]) / (float) numSamples;
+    amplitudeStep[v] = (level - amplitude[v]) / (float) numSamples;
+}
+
+float MpeVoicePool::getTargetIncrement (int v) const noexcept
+{
+    const auto semitones = (double) noteNumber[v] + lanes[noteBend].current[v] + lanes[masterBend].current[v];
+    return juce::jmin (maxPhaseIncrement, (float) (440.0 * detune[v] * std::exp2 ((semitones - 69.0) / 12.0) / sampleRate));
+}
+
+void MpeVoicePool::renderVoices (float* output, int numSamples) noexcept
+{
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if (! active[v])
+            continue;
+
+        auto p = phase[v];
+        auto increment = phaseIncrement[v];
+        auto amp = amplitude[v];
+        const auto incrementStep = phaseIncrementStep[v];
+        const auto ampStep = amplitudeStep[v];
+        const auto harmonic = lanes[timbre].current[v];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto angle = juce::MathConstants<float>::twoPi * p;
+            const auto s = std::sin (angle);
+
+            // sin(2x) = 2 sin(x) cos(x): the second harmonic, mixed in by timbre
+            output[i] += amp * s * (1.0f + harmonic * std::cos (angle));
+
+            p += increment;
+            p -= p >= 1.0f ? 1.0f : 0.0f;
+            increment += incrementStep;
+            amp += ampStep;
+        }
+
+        phase[v] = p;
+        phaseIncrement[v] = increment;
+        amplitude[v] = amp;
+    }
+}
+
+//==============================================================================
+int MpeVoicePool::getNumActiveVoices() const noexcept
+{
+    return (int) std::count (std::begin (active), std::end (active), true);
+}
+
+int MpeVoicePool::findVoice (int channel, int note) const noexcept
+{
+    for (int v = 0; v < maxVoices; ++v)
+        if (active[v] && ! released[v] && getChannel (v) == channel && getNote (v) == note)
+            return v;
+
+    return -1;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "PreparsedMidiBuffer.h"
+
+#include <optional>
+
+/**
+    A fixed pool of simple sine voices with MPE per-note expression.
+
+    All voice state lives in structure-of-arrays form: one contiguous array
+    per field, indexed by voice. Each expression dimension is a lane with a
+    current and a target array; events only write targets, and once per
+    controlInterval samples every lane of every voice is smoothed in one
+    straight loop. That loop runs the same whether the controller is sending
+    nothing or a dense stream of MPE data, so expression costs no more than
+    plain MIDI at the same voice count: an incoming bend is a couple of
+    stores into arrays that are already in cache.
+
+    Lanes:
+    - noteBend: the bend of the voice's own channel. In an MPE zone that is
+      the per-note bend; outside one it is ordinary channel pitch bend.
+    - masterBend: the bend of an MPE zone's master channel, shared by its members.
+    - pressure: channel or poly pressure, scaling the voice's level.
+    - timbre: CC74, mixing in the second harmonic.
+
+    Zone configuration comes from the MCM messages decoded by PreparsedMidiBuffer.
+
+    When every voice is busy the oldest is stolen. It fades out over a few
+    milliseconds rather than being cut, and the new note starts on it at the
+    control tick where the fade reaches silence. From the moment it is
+    stolen the voice answers to the new note.
+
+    Drift gives each note a small random detune and start phase, like an
+    analogue oscillator bank. The randomness comes from a free-running
+    generator, or, once setDriftSeed() is given a seed, from that seed and
+    the note's ID, so the same performance renders identically every time.
+*/
+class MpeVoicePool
+{
+public:
+    //==============================================================================
+    static constexpr int maxVoices = 32;
+    static constexpr int controlInterval = 32;
+
+    enum Lane
+    {
+        noteBend,
+        masterBend,
+        pressure,
+        timbre,
+        numLanes
+    };
+
+    //==============================================================================
+    void prepare (double sampleRate, int maxBlockSize);
+    void reset() noexcept;
+
+    /** Applies one decoded event. Notes start at once; expression is picked up at the next control tick. */
+    void handleEvent (const PreparsedMidiBuffer::Event& event, const juce::MPEZoneLayout& zones) noexcept;
+
+    /** Adds numSamples of every active voice to all channels of block, starting at startSample. */
+    void render (juce::AudioBuffer<float>& block, int startSample, int numSamples) noexcept;
+
+    /** Per-note detune and start phase spread, 0 to 1. Applies to notes started afterwards. */
+    void setDrift (float amount) noexcept                       { drift = juce::jlimit (0.0f, 1.0f, amount); }
+
+    /**
+        Seeds each note's drift from seed and the note's ID (its start count
+        since reset(), channel and number) instead of a free-running generator.
+        Pass std::nullopt to go back.
+    */
+    void setDriftSeed (std::optional<juce::uint64> seed) noexcept  { driftSeed = seed; }
+
+    //==============================================================================
+    int getNumActiveVoices() const noexcept;
+
+    /** The voice playing this note on this channel, or -1. Released voices are ignored. */
+    int findVoice (int channel, int note) const noexcept;
+
+    /** A voice's smoothed value of one expression lane. */
+    float getExpression (int voice, Lane lane) const noexcept  { return lanes[lane].current[voice]; }
+
+private:
+    //==============================================================================
+    struct ExpressionLane
+    {
+        alignas (16) float current[maxVoices] {};
+        alignas (16) float target[maxVoices] {};
+    };
+
+    void startVoice (const PreparsedMidiBuffer::Event& event, const juce::MPEZoneLayout& zones) noexcept;
+
+    /** Starts event's note on voice from silence. master is its zone's master channel, or 0. */
+    void playNote (int voice, const PreparsedMidiBuffer::Event& event, int master) noexcept;
+
+    /** The channel and note a voice answers to: a stolen voice's are its pending note's. */
+    int getChannel (int v) const noexcept   { return stolen[v] ? pendingNote[v].channel : midiChannel[v]; }
+    int getNote (int v) const noexcept      { return stolen[v] ? pendingNote[v].note : noteNumber[v]; }
+
+    /** Advances every lane by one tick and sets each active voice's ramps to its end. */
+    void updateControl (int numSamples) noexcept;
+    void updateVoiceControl (int voice, int numSamples) noexcept;
+
+    /** Phase increment, in cycles per sample, for the voice's note plus its smoothed bends. */
+    float getTargetIncrement (int voice) const noexcept;
+    void renderVoices (float* output, int numSamples) noexcept;
+
+    ExpressionLane lanes[numLanes];
+
+    // Per-voice state, one array per field
+    alignas (16) float phase[maxVoices] {};
+    alignas (16) float phaseIncrement[maxVoices] {};
+    alignas (16) float phaseIncrementStep[maxVoices] {};
+    alignas (16) float amplitude[maxVoices] {};
+    alignas (16) float amplitudeStep[maxVoices] {};
+    alignas (16) float envelope[maxVoices] {};
+    alignas (16) float velocity[maxVoices] {};
+    alignas (16) float detune[maxVoices] {};         /**< Frequency ratio from drift. */
+    juce::uint32 startOrder[maxVoices] {};
+    juce::uint8 noteNumber[maxVoices] {};
+    juce::uint8 midiChannel[maxVoices] {};
+    bool active[maxVoices] {};
+    bool released[maxVoices] {};
+    bool stolen[maxVoices] {};                      /**< Fading out before pendingNote starts. */
+    PreparsedMidiBuffer::Event pendingNote[maxVoices];
+    juce::uint8 pendingMaster[maxVoices] {};
+
+    // Last expression seen on each channel, so a note starts from its channel's state
+    float channelState[numLanes][16] {};
+
+    juce::HeapBlock<float> scratch;
+    int scratchSize = 0;
+    double sampleRate = 44100.0;
+    float smoothing = 1.0f;             /**< One-pole coefficient per control tick, about 5ms. */
+    float attackPerSample = 0.0f;
+    float releasePerSample = 0.0f;
+    float stealFadePerSample = 0.0f;
+    int samplesUntilControl = 0;
+    juce::uint32 nextStartOrder = 0;
+
+    float drift = 0.0f;
+    std::optional<juce::uint64> driftSeed;
+    juce::Random driftRandom;           /**< Seeded randomly; used when there's no driftSeed. */
+};
@@ -0,0 +1,171 @@
+#include "MultibandCompressor.h"
+
+//==============================================================================
+void MultibandCompressor::prepare (double newSampleRate, int maxBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+
+    const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) maxBlockSize, (juce::uint32) numChannels };
+
+    lowSplit.prepare (spec);
+    highSplit.prepare (spec);
+    lowAllpass.prepare (spec);
+    lowAllpass.setType (juce::dsp::LinkwitzRileyFilterType::allpass);
+
+    lowCrossover.reset (sampleRate, 0.05);
+    highCrossover.reset (sampleRate, 0.05);
+
+    bandBuffer.setSize (numBands * numChannels, subBlockSize);
+    gainRamp.allocate ((size_t) subBlockSize, true);
+
+    attackCoefficient = 0.0f;   // force setTimes() to recompute for the new rate
+    setTimes (attackMs, releaseMs);
+    reset();
+}
+
+void MultibandCompressor::reset()
+{
+    lowCrossover.setCurrentAndTargetValue (lowCrossover.getTargetValue());
+    highCrossover.setCurrentAndTargetValue (highCrossover.getTargetValue());
+
+    lowSplit.setCutoffFrequency (lowCrossover.getTargetValue());
+    highSplit.setCutoffFrequency (highCrossover.getTargetValue());
+    lowAllpass.setCutoffFrequency (highCrossover.getTargetValue());
+
+    lowSplit.reset();
+    highSplit.reset();
+    lowAllpass.reset();
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        bands[b].envelope = 0.0f;
+        bands[b].gain = 1.0f;
+        gainReduction[b].store (0.0f, std::memory_order_relaxed);
+    }
+}
+
+void MultibandCompressor::setCrossovers (float lowFrequency, float highFrequency) noexcept
+{
+    // Keep the bands ordered whatever the user does with the two controls
+    highFrequency = juce::jmax (highFrequency, lowFrequency * 1.5f);
+
+    if (! juce::approximatelyEqual (lowCrossover.getTargetValue(), lowFrequency))
+        lowCrossover.setTargetValue (lowFrequency);
+
+    if (! juce::approximatelyEqual (highCrossover.getTargetValue(), highFrequency))
+        highCrossover.setTargetValue (highFrequency);
+}
+
+void MultibandCompressor::setBand (int band, float thresholdDecibels, float ratio) noexcept
+{
+    bands[band].threshold = thresholdDecibels;
+    bands[band].ratio = juce::jmax (1.0f, ratio);
+}
+
+void MultibandCompressor::setTimes (float newAttackMs, float newReleaseMs) noexcept
+{
+    if (juce::approximatelyEqual (attackMs, newAttackMs) && juce::approximatelyEqual (releaseMs, newReleaseMs)
+        && attackCoefficient != 0.0f)
+        return;
+
+    attackMs = newAttackMs;
+    releaseMs = newReleaseMs;
+    attackCoefficient = (float) std::exp (-1000.0 / (juce::jmax (0.01f, attackMs) * sampleRate));
+    releaseCoefficient = (float) std::exp (-1000.0 / (juce::jmax (0.01f, releaseMs) * sampleRate));
+}
+
+//==============================================================================
+void MultibandCompressor::process (juce::AudioBuffer<float>& block) noexcept
+{
+    if (! enabled)
+    {
+        wasEnabled = false;
+        return;
+    }
+
+    // Don't resume from stale filter and envelope state
+    if (! wasEnabled)
+    {
+        reset();
+        wasEnabled = true;
+    }
+
+    for (int start = 0; start < block.getNumSamples(); start += subBlockSize)
+        processChunk (block, start, juce::jmin (subBlockSize, block.getNumSamples() - start));
+}
+
+void MultibandCompressor::processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept
+{
+    if (lowCrossover.isSmoothing() || highCrossover.isSmoothing())
+    {
+        const auto low = lowCrossover.skip (num);
+        const auto high = highCrossover.skip (num);
+        lowSplit.setCutoffFrequency (low);
+        highSplit.setCutoffFrequency (high);
+        lowAllpass.setCutoffFrequency (high);
+    }
+
+    const auto channels = juce::jmin (numChannels, block.getNumChannels());
+
+    // Split: low = AP(high, LP(low, x)), mid = LP(high, HP(low, x)), high = HP(high, HP(low, x))
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const auto* in = block.getReadPointer (ch, start);
+        auto* low  = bandBuffer.getWritePointer (ch);
+        auto* mid  = bandBuffer.getWritePointer (numChannels + ch);
+        auto* high = bandBuffer.getWritePointer (2 * numChannels + ch);
+
+        for (int i = 0; i < num; ++i)
+        {
+            float lowPart, rest;
+            lowSplit.processSample (ch, in[i], lowPart, rest);
+            highSplit.processSample (ch, rest, mid[i], high[i]);
+            low[i] = lowAllpass.processSample (ch, lowPart);
+        }
+    }
+
+    block.clear (start, num);
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        auto& band = bands[b];
+        auto envelope = band.envelope;
+
+        // Linked peak detection
+        for (int i = 0; i < num; ++i)
+        {
+            float peak = 0.0f;
+
+            for (int ch = 0; ch < channels; ++ch)
+                peak = juce::jmax (peak, std::abs (bandBuffer.getSample (b * numChannels + ch, i)));
+
+            const auto coefficient = peak > envelope ? attackCoefficient : releaseCoefficient;
+            envelope = peak + coefficient * (envelope - peak);
+        }
+
+        band.envelope = envelope;
+
+        // Gain computer, once per sub-block
+        const auto over = juce::Decibels::gainToDecibels (envelope, -120.0f) - band.threshold;
+        const auto reduction = over > 0.0f ? over * (1.0f - 1.0f / band.ratio) : 0.0f;
+        const auto target = juce::Decibels::decibelsToGain (-reduction);
+        gainReduction[b].store (reduction, std::memory_order_relaxed);
+
+        const auto increment = (target - band.gain) / (float) num;
+
+        for (int i = 0; i < num; ++i)
+            gainRamp[i] = band.gain + increment * (float) (i + 1);
+
+        band.gain = target;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            auto* out = block.getWritePointer (ch, start);
+            const auto* part = bandBuffer.getReadPointer (b * numChannels + ch);
+
+            for (int i = 0; i < num; ++i)
+                out[i] += part[i] * gainRamp[i];
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+    A three-band compressor split by fourth-order Linkwitz-Riley crossovers.
+
+    The low band also goes through an allpass at the upper crossover so the
+    three bands sum back to a flat magnitude response. Detection is stereo
+    linked peak, per sample; the gain computer (the only place with logs and
+    exponentials) runs once per subBlockSize samples per band, and the gain is
+    ramped linearly across each sub-block. Crossover frequencies glide and
+    their coefficients are updated per sub-block, never per sample.
+*/
+class MultibandCompressor
+{
+public:
+    //==============================================================================
+    static constexpr int numBands = 3;
+    static constexpr int subBlockSize = 32;
+
+    //==============================================================================
+    void prepare (double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+
+    void setEnabled (bool shouldBeEnabled) noexcept     { enabled = shouldBeEnabled; }
+    void setCrossovers (float lowFrequency, float highFrequency) noexcept;
+    void setBand (int band, float thresholdDecibels, float ratio) noexcept;
+    void setTimes (float attackMs, float releaseMs) noexcept;
+
+    void process (juce::AudioBuffer<float>& block) noexcept;
+
+    /** The most recent gain reduction of a band, in positive dB. Safe to read from any thread. */
+    float getGainReductionDecibels (int band) const noexcept { return gainReduction[band].load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    void processChunk (juce::AudioBuffer<float>& block, int start, int num) noexcept;
+
+    struct Band
+    {
+        float threshold = 0.0f;
+        float ratio = 1.0f;
+        float envelope = 0.0f;
+        float gain = 1.0f;
+    };
+
+    juce::dsp::LinkwitzRileyFilter<float> lowSplit, highSplit, lowAllpass;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowCrossover { 200.0f }, highCrossover { 2000.0f };
+
+    Band bands[numBands];
+    std::atomic<float> gainReduction[numBands] {};
+
+    juce::AudioBuffer<float> bandBuffer;    /**< numBands * numChannels channels of subBlockSize samples. */
+    juce::HeapBlock<float> gainRamp;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    float attackCoefficient = 0.0f;
+    float releaseCoefficient = 0.0f;
+    float attackMs = 10.0f, releaseMs = 100.0f;
+    bool enabled = false;
+    bool wasEnabled = false;
+};
@@ -0,0 +1,290 @@
+#include "NativeControls.h"
+#include "Params.h"
+
+namespace
+{
+    constexpr float meterFallDecibelsPerSecond = 20.0f;
+    constexpr float tickSpacingDecibels = 6.0f;
+    constexpr float spectrumGridDecibels = 24.0f;
+    constexpr int readoutHeight = 16;
+
+    const juce::Colour panelColour { 0xff1e1e1e };
+    const juce::Colour unlitColour { 0xff2c2c2c };
+    const juce::Colour labelColour { 0xffa0a0a0 };
+    const juce::Colour curveColour { 0xff4fc3f7 };
+}
+
+//==============================================================================
+LevelMeter::LevelMeter()
+{
+    // Nothing behind a meter ever needs repainting when it changes
+    setOpaque (true);
+}
+
+juce::Rectangle<int> LevelMeter::setLevel (float newLevel)
+{
+    level = newLevel;
+    const auto newTop = getBarTop (newLevel);
+
+    if (newTop == barTop)
+        return {};
+
+    const auto dirty = juce::Rectangle<int> (0, juce::jmin (barTop, newTop), getWidth(), std::abs (newTop - barTop));
+    barTop = newTop;
+    repaint (dirty);
+    return dirty;
+}
+
+void LevelMeter::setLayerCachingEnabled (bool shouldCache)
+{
+    unlitLayer.setCachingEnabled (shouldCache);
+    litLayer.setCachingEnabled (shouldCache);
+}
+
+void LevelMeter::paint (juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds();
+
+    {
+        const juce::Graphics::ScopedSaveState state (g);
+        g.reduceClipRegion (bounds.withBottom (barTop));
+        unlitLayer.draw (g, bounds, [this] (juce::Graphics& lg) { paintScale (lg, false); });
+    }
+
+    const juce::Graphics::ScopedSaveState state (g);
+    g.reduceClipRegion (bounds.withTop (barTop));
+    litLayer.draw (g, bounds, [this] (juce::Graphics& lg) { paintScale (lg, true); });
+}
+
+void LevelMeter::resized()
+{
+    barTop = getBarTop (level);
+}
+
+int LevelMeter::getBarTop (float levelToShow) const noexcept
+{
+    const auto decibels = juce::Decibels::gainToDecibels (levelToShow, minimumDecibels);
+    const auto proportion = juce::jlimit (0.0f, 1.0f, (decibels - minimumDecibels) / -minimumDecibels);
+    return juce::roundToInt ((float) getHeight() * (1.0f - proportion));
+}
+
+void LevelMeter::paintScale (juce::Graphics& g, bool lit) const
+{
+    const auto width = (float) getWidth();
+    const auto height = (float) getHeight();
+
+    if (lit)
+    {
+        juce::ColourGradient gradient (juce::Colours::red, 0.0f, 0.0f, juce::Colours::limegreen, 0.0f, height, false);
+        gradient.addColour (12.0 / -minimumDecibels, juce::Colours::yellow);
+        g.setGradientFill (gradient);
+    }
+    else
+    {
+        g.setColour (unlitColour);
+    }
+
+    g.fillRect (0.0f, 0.0f, width, height);
+
+    // A tick every 6 dB, darker than either layer so it reads on both
+    g.setColour (juce::Colours::black.withAlpha (0.5f));
+
+    for (auto decibels = -tickSpacingDecibels; decibels > minimumDecibels; decibels -= tickSpacingDecibels)
+        g.fillRect (0.0f, height * decibels / minimumDecibels, width, 1.0f);
+}
+
+//==============================================================================
+SpectrumView::SpectrumView()
+{
+    setOpaque (true);
+}
+
+void SpectrumView::setResults (const SpectrumAnalyser::Results& results)
+{
+    curve.clear();
+    const auto area = getPlotArea().toFloat();
+
+    if (results.sampleRate > 0.0 && ! area.isEmpty())
+    {
+        const auto binWidth = (float) (results.sampleRate / SpectrumAnalyser::fftSize);
+        const auto logRange = std::log (maximumFrequency / minimumFrequency);
+        auto lastX = -1.0f;
+
+        for (int bin = 1; bin < SpectrumAnalyser::numBins; ++bin)
+        {
+            const auto frequency = (float) bin * binWidth;
+
+            if (frequency < minimumFrequency)
+                continue;
+
+            if (frequency > maximumFrequency)
+                break;
+
+            // Bins crowd together at the top; one point per pixel column is plenty
+            const auto x = area.getX() + area.getWidth() * std::log (frequency / minimumFrequency) / logRange;
+
+            if (x - lastX < 1.0f)
+                continue;
+
+            const auto proportion = juce::jlimit (0.0f, 1.0f, results.spectrum[bin] / minimumDecibels);
+            const auto y = area.getY() + area.getHeight() * proportion;
+
+            if (curve.isEmpty())
+                curve.startNewSubPath (x, y);
+            else
+                curve.lineTo (x, y);
+
+            lastX = x;
+        }
+    }
+
+    auto formatLufs = [] (float lufs)
+    {
+        return lufs > SpectrumAnalyser::silenceLufs ? juce::String (lufs, 1) : juce::String ("-inf");
+    };
+
+    readout = "S " + formatLufs (results.shortTermLufs) + "   I " + formatLufs (results.integratedLufs) + " LUFS";
+    repaint();
+}
+
+void SpectrumView::paint (juce::Graphics& g)
+{
+    gridLayer.draw (g, getLocalBounds(), [this] (juce::Graphics& lg) { paintGrid (lg); });
+
+    g.setColour (curveColour);
+    g.strokePath (curve, juce::PathStrokeType (1.5f));
+
+    g.setColour (labelColour);
+    g.setFont (juce::FontOptions (12.0f));
+    g.drawText (readout, getLocalBounds().removeFromBottom (readoutHeight), juce::Justification::centredLeft);
+}
+
+void SpectrumView::resized()
+{
+    // The curve was laid out for the old size; the next results redraw it
+    curve.clear();
+}
+
+juce::Rectangle<int> SpectrumView::getPlotArea() const noexcept
+{
+    return getLocalBounds().withTrimmedBottom (readoutHeight);
+}
+
+void SpectrumView::paintGrid (juce::Graphics& g) const
+{
+    g.fillAll (unlitColour);
+
+    const auto area = getPlotArea().toFloat();
+    const auto logRange = std::log (maximumFrequency / minimumFrequency);
+    g.setColour (juce::Colours::black.withAlpha (0.5f));
+
+    for (auto frequency : { 100.0f, 1000.0f, 10000.0f })
+        g.fillRect (area.getX() + area.getWidth() * std::log (frequency / minimumFrequency) / logRange,
+                    area.getY(), 1.0f, area.getHeight());
+
+    for (auto decibels = -spectrumGridDecibels; decibels > minimumDecibels; decibels -= spectrumGridDecibels)
+        g.fillRect (area.getX(), area.getY() + area.getHeight() * decibels / minimumDecibels, area.getWidth(), 1.0f);
+
+    g.setColour (panelColour);
+    g.fillRect (getLocalBounds().removeFromBottom (readoutHeight));
+}
+
+//==============================================================================
+NativeControls::NativeControls (VstTestPlaygroundAudioProcessor& p)
+    : processorRef (p),
+      gainAttachment (p.apvts, Params::gain.id, gainSlider)
+{
+    setOpaque (true);
+
+    addAndMakeVisible (gainSlider);
+
+    for (auto& meter : meters)
+        addAndMakeVisible (meter);
+
+    addAndMakeVisible (spectrum);
+}
+
+NativeControls::~NativeControls() = default;
+
+juce::RectangleList<int> NativeControls::setMeterLevels (float left, float right)
+{
+    juce::RectangleList<int> dirty;
+    const float levels[] = { left, right };
+
+    for (int i = 0; i < 2; ++i)
+        if (const auto area = meters[i].setLevel (levels[i]); ! area.isEmpty())
+            dirty.add (area + meters[i].getPosition());
+
+    return dirty;
+}
+
+void NativeControls::setLayerCachingEnabled (bool shouldCache)
+{
+    background.setCachingEnabled (shouldCache);
+
+    for (auto& meter : meters)
+        meter.setLayerCachingEnabled (shouldCache);
+
+    spectrum.setLayerCachingEnabled (shouldCache);
+    repaint();
+}
+
+void NativeControls::paint (juce::Graphics& g)
+{
+    background.draw (g, getLocalBounds(), [this] (juce::Graphics& lg)
+    {
+        lg.fillAll (panelColour);
+        lg.setColour (labelColour);
+        lg.setFont (juce::FontOptions (13.0f));
+        lg.drawText ("GAIN", gainLabelArea, juce::Justification::centred);
+        lg.drawText ("OUT", meterLabelArea, juce::Justification::centred);
+    });
+}
+
+void NativeControls::resized()
+{
+    auto bounds = getLocalBounds().reduced (16);
+    spectrum.setBounds (bounds.removeFromBottom (bounds.getHeight() / 3));
+    bounds.removeFromBottom (8);
+
+    auto meterArea = bounds.removeFromRight (48);
+
+    meterLabelArea = meterArea.removeFromBottom (20);
+    meters[0].setBounds (meterArea.removeFromLeft (20));
+    meters[1].setBounds (meterArea.removeFromRight (20));
+
+    gainLabelArea = bounds.removeFromBottom (20);
+    gainSlider.setBounds (bounds.withSizeKeepingCentre (juce::jmin (bounds.getWidth(), bounds.getHeight()),
+                                                        juce::jmin (bounds.getWidth(), bounds.getHeight())));
+}
+
+void NativeControls::visibilityChanged()
+{
+    if (! isVisible())
+    {
+        vBlankAttachment.reset();
+        return;
+    }
+
+    if (vBlankAttachment == nullptr)
+    {
+        // The meters fall from where they were hidden, not by the time spent hidden
+        lastUpdateTime = 0.0;
+        vBlankAttachment = std::make_unique<juce::VBlankAttachment> (this, [this] { updateMeters(); });
+    }
+}
+
+void NativeControls::updateMeters()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = lastUpdateTime > 0.0 ? (float) ((now - lastUpdateTime) * 0.001) : 0.0f;
+    lastUpdateTime = now;
+
+    const auto fall = juce::Decibels::decibelsToGain (-meterFallDecibelsPerSecond * elapsedSeconds);
+
+    setMeterLevels (juce::jmax (processorRef.takeOutputPeak (0), meters[0].getLevel() * fall),
+                    juce::jmax (processorRef.takeOutputPeak (1), meters[1].getLevel() * fall));
+
+    if (auto& analyser = processorRef.getAnalyser(); analyser.hasNewResults())
+        spectrum.setResults (analyser.getLatestResults());
+}
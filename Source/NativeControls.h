@@ -0,0 +1,140 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "CachedLayer.h"
+
+//==============================================================================
+/**
+    A vertical peak meter from minimumDecibels to 0 dB.
+
+    Both of its layers are cached: the unlit scale and the lit gradient bar.
+    A paint is two clipped blits, and setLevel() repaints only the strip
+    between the old and new top of the bar, so a meter that barely moves
+    costs a few rows of pixels.
+*/
+class LevelMeter  : public juce::Component
+{
+public:
+    //==============================================================================
+    static constexpr float minimumDecibels = -60.0f;
+
+    LevelMeter();
+
+    /**
+        Sets the linear peak level and repaints what changed. Returns that
+        area, which is empty if the bar didn't move by a whole pixel.
+    */
+    juce::Rectangle<int> setLevel (float newLevel);
+    float getLevel() const noexcept                 { return level; }
+
+    void setLayerCachingEnabled (bool shouldCache);
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    int getBarTop (float levelToShow) const noexcept;
+    void paintScale (juce::Graphics&, bool lit) const;
+
+    CachedLayer unlitLayer, litLayer;
+    float level = 0.0f;
+    int barTop = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
+
+//==============================================================================
+/**
+    The output spectrum on a log-frequency axis, with the short-term and
+    integrated loudness underneath.
+
+    The grid is a cached layer; only the curve and the readout are drawn per
+    update, and only when the analyser has published something new.
+*/
+class SpectrumView  : public juce::Component
+{
+public:
+    //==============================================================================
+    static constexpr float minimumFrequency = 20.0f;
+    static constexpr float maximumFrequency = 20000.0f;
+    static constexpr float minimumDecibels = -96.0f;
+
+    SpectrumView();
+
+    /** Rebuilds the curve and readout from results and repaints. */
+    void setResults (const SpectrumAnalyser::Results& results);
+
+    void setLayerCachingEnabled (bool shouldCache)  { gridLayer.setCachingEnabled (shouldCache); }
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    juce::Rectangle<int> getPlotArea() const noexcept;
+    void paintGrid (juce::Graphics&) const;
+
+    CachedLayer gridLayer;
+    juce::Path curve;
+    juce::String readout;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumView)
+};
+
+//==============================================================================
+/**
+    The native controls: a gain knob, a stereo output meter and the output
+    spectrum. The editor shows them when the WebView can't be used, or as an
+    overlay on request.
+
+    Everything static (the panel, its labels, the knob body, the meter
+    scales) is a CachedLayer, so repaints are blits plus the pointer and
+    the bars. The meters follow the processor's output peaks once per
+    display refresh, falling back at 20 dB/s, and repaint only the rows that
+    changed; the spectrum repaints when the analyser has new results. When
+    nothing moves, nothing is painted. The display refresh callback is only
+    attached while the controls are visible, so hidden ones neither wake up
+    nor take the peaks and results.
+*/
+class NativeControls  : public juce::Component
+{
+public:
+    //==============================================================================
+    explicit NativeControls (VstTestPlaygroundAudioProcessor& processor);
+    ~NativeControls() override;
+
+    /** Sets both meters directly and returns the area they repainted, in our coordinates. */
+    juce::RectangleList<int> setMeterLevels (float left, float right);
+
+    /** Turns every layer cache on or off, for paint benchmarks. The knob's is in CustomLookAndFeel. */
+    void setLayerCachingEnabled (bool shouldCache);
+
+    juce::Slider& getGainSlider() noexcept          { return gainSlider; }
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    //==============================================================================
+    /** Once per display refresh: pulls the latest peaks and spectrum, and lets the meters fall. */
+    void updateMeters();
+
+    VstTestPlaygroundAudioProcessor& processorRef;
+    juce::Slider gainSlider { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::NoTextBox };
+    juce::AudioProcessorValueTreeState::SliderAttachment gainAttachment;
+    LevelMeter meters[2];
+    SpectrumView spectrum;
+
+    CachedLayer background;
+    juce::Rectangle<int> gainLabelArea, meterLabelArea;
+
+    std::unique_ptr<juce::VBlankAttachment> vBlankAttachment;    /**< Only while visible. */
+    double lastUpdateTime = 0.0;    /**< Milliseconds, from Time::getMillisecondCounterHiRes(). */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NativeControls)
+};
@@ -0,0 +1,112 @@
+#include "ParameterSnapshot.h"
+
+//==============================================================================
+ParameterSnapshot::ParameterSnapshot (juce::AudioProcessorValueTreeState& state)
+    : processor (state.processor),
+      stateType (state.state.getType())
+{
+    cachedXml = std::make_unique<juce::XmlElement> (stateType);
+
+    for (auto* p : processor.getParameters())
+    {
+        auto* slot = slots.add (new Slot());
+        slot->parameter = dynamic_cast<juce::RangedAudioParameter*> (p);
+        slot->normalisedValue.store (p->getValue());
+
+        if (slot->parameter != nullptr)
+        {
+            slot->element = cachedXml->createNewChildElement ("PARAM");
+            slot->element->setAttribute ("id", slot->parameter->getParameterID());
+            slot->element->setAttribute ("value", (double) slot->parameter->convertFrom0to1 (p->getValue()));
+        }
+
+        p->addListener (this);
+    }
+}
+
+ParameterSnapshot::~ParameterSnapshot()
+{
+    for (auto* p : processor.getParameters())
+        p->removeListener (this);
+}
+
+//==============================================================================
+void ParameterSnapshot::parameterValueChanged (int parameterIndex, float newValue)
+{
+    // May be called on the audio thread: atomics only.
+    if (auto* slot = slots[parameterIndex])
+    {
+        slot->normalisedValue.store (newValue, std::memory_order_relaxed);
+        slot->dirty.store (true, std::memory_order_release);
+        version.fetch_add (1, std::memory_order_release);
+    }
+}
+
+void ParameterSnapshot::setProperty (const juce::Identifier& name, const juce::String& value)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl (propertyLock);
+
+        if (! properties.set (name, value))
+            return;
+    }
+
+    version.fetch_add (1, std::memory_order_release);
+}
+
+void ParameterSnapshot::writeTo (juce::MemoryBlock& destData)
+{
+    // Another thread is refreshing the cache: serialise straight from the
+    // atomic slots rather than wait for it.
+    if (writing.test_and_set (std::memory_order_acquire))
+    {
+        juce::AudioProcessor::copyXmlToBinary (*createXml(), destData);
+        return;
+    }
+
+    const auto currentVersion = version.load (std::memory_order_acquire);
+
+    if (currentVersion != cachedVersion)
+    {
+        for (auto* slot : slots)
+            if (slot->element != nullptr && slot->dirty.exchange (false, std::memory_order_acquire))
+                slot->element->setAttribute ("value", (double) slot->parameter->convertFrom0to1 (slot->normalisedValue.load (std::memory_order_relaxed)));
+
+        {
+            const juce::SpinLock::ScopedLockType sl (propertyLock);
+
+            for (const auto& property : properties)
+                cachedXml->setAttribute (property.name, property.value.toString());
+        }
+
+        juce::AudioProcessor::copyXmlToBinary (*cachedXml, cachedBinary);
+        cachedVersion = currentVersion;
+    }
+
+    destData = cachedBinary;
+    writing.clear (std::memory_order_release);
+}
+
+std::unique_ptr<juce::XmlElement> ParameterSnapshot::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement> (stateType);
+
+    {
+        const juce::SpinLock::ScopedLockType sl (propertyLock);
+
+        for (const auto& property : properties)
+            xml->setAttribute (property.name, property.value.toString());
+    }
+
+    for (auto* slot : slots)
+    {
+        if (slot->parameter == nullptr)
+            continue;
+
+        auto* element = xml->createNewChildElement ("PARAM");
+        element->setAttribute ("id", slot->parameter->getParameterID());
+        element->setAttribute ("value", (double) slot->parameter->convertFrom0to1 (slot->normalisedValue.load (std::memory_order_relaxed)));
+    }
+
+    return xml;
+}
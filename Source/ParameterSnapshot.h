@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/**
+    A lock-free mirror of every parameter value, used to save state without
+    touching the AudioProcessorValueTreeState's ValueTree.
+
+    Each parameter change (from any thread, including the audio thread) stores
+    the new value in an atomic slot and marks it dirty. writeTo() then only
+    reformats the dirty slots into its cached XML and reuses the last binary
+    blob outright when nothing has changed, so periodic host autosaves cost
+    O(parameters changed) and never contend with UI edits on the tree.
+
+    The output is the same "Parameters"/"PARAM" XML that apvts.copyState()
+    produces, so setStateInformation() and older sessions are unaffected.
+*/
+class ParameterSnapshot  : private juce::AudioProcessorParameter::Listener
+{
+public:
+    //==============================================================================
+    explicit ParameterSnapshot (juce::AudioProcessorValueTreeState& state);
+    ~ParameterSnapshot() override;
+
+    //==============================================================================
+    /** Serialises the latest parameter values, in copyXmlToBinary() format. */
+    void writeTo (juce::MemoryBlock& destData);
+
+    /**
+        Stores a non-parameter value, such as an asset path, as an attribute of
+        the root element. Not for the audio thread.
+    */
+    void setProperty (const juce::Identifier& name, const juce::String& value);
+
+    /** Increments whenever any parameter changes; useful for cheap "has anything changed?" checks. */
+    juce::uint32 getVersion() const noexcept { return version.load (std::memory_order_acquire); }
+
+private:
+    //==============================================================================
+    void parameterValueChanged (int parameterIndex, float newValue) override;
+    void parameterGestureChanged (int, bool) override {}
+
+    std::unique_ptr<juce::XmlElement> createXml() const;
+
+    struct Slot
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        juce::XmlElement* element = nullptr;        /**< This parameter's PARAM child in cachedXml. */
+        std::atomic<float> normalisedValue { 0.0f };
+        std::atomic<bool> dirty { false };
+    };
+
+    juce::AudioProcessor& processor;
+    juce::Identifier stateType;                     /**< The apvts state type, used as the XML tag. */
+    juce::OwnedArray<Slot> slots;                   /**< Indexed like processor.getParameters(). */
+    std::atomic<juce::uint32> version { 1 };
+
+    juce::SpinLock propertyLock;                    /**< Guards properties; never taken on the audio thread. */
+    juce::NamedValueSet properties;
+
+    std::atomic_flag writing = ATOMIC_FLAG_INIT;    /**< Guards the cache below without blocking. */
+    std::unique_ptr<juce::XmlElement> cachedXml;
+    juce::MemoryBlock cachedBinary;
+    juce::uint32 cachedVersion = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSnapshot)
+};
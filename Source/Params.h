@@ -10,9 +10,73 @@ namespace Params
         const float minValue;
         const float maxValue;
         const float defaultValue;
+        const float skewCentre = 0.0f; /**< If non-zero, the value at the centre of the control. */
     };
 
     static const ParameterMetadata gain = { "gain", "Gain", -60.0f, 12.0f, 0.0f };
 
     inline const juce::String GAIN_ID { "gain" };
+
+    //==============================================================================
+    // Parametric EQ (peaking bands)
+    constexpr int numEqBands = 4;
+
+    static const ParameterMetadata eqFrequency[numEqBands] = {
+        { "eq1Freq", "EQ 1 Frequency", 20.0f, 20000.0f,  100.0f, 1000.0f },
+        { "eq2Freq", "EQ 2 Frequency", 20.0f, 20000.0f,  500.0f, 1000.0f },
+        { "eq3Freq", "EQ 3 Frequency", 20.0f, 20000.0f, 2000.0f, 1000.0f },
+        { "eq4Freq", "EQ 4 Frequency", 20.0f, 20000.0f, 8000.0f, 1000.0f }
+    };
+
+    static const ParameterMetadata eqGain[numEqBands] = {
+        { "eq1Gain", "EQ 1 Gain", -18.0f, 18.0f, 0.0f },
+        { "eq2Gain", "EQ 2 Gain", -18.0f, 18.0f, 0.0f },
+        { "eq3Gain", "EQ 3 Gain", -18.0f, 18.0f, 0.0f },
+        { "eq4Gain", "EQ 4 Gain", -18.0f, 18.0f, 0.0f }
+    };
+
+    static const ParameterMetadata eqQ[numEqBands] = {
+        { "eq1Q", "EQ 1 Q", 0.1f, 10.0f, 0.707f, 1.0f },
+        { "eq2Q", "EQ 2 Q", 0.1f, 10.0f, 0.707f, 1.0f },
+        { "eq3Q", "EQ 3 Q", 0.1f, 10.0f, 0.707f, 1.0f },
+        { "eq4Q", "EQ 4 Q", 0.1f, 10.0f, 0.707f, 1.0f }
+    };
+
+    //==============================================================================
+    // Multiband compressor (low / mid / high)
+    constexpr int numCompressorBands = 3;
+
+    static const ParameterMetadata mbEnabled = { "mbEnabled", "Multiband On", 0.0f, 1.0f, 0.0f };
+    static const ParameterMetadata mbLowCrossover = { "mbLowXover", "Multiband Low Crossover", 20.0f, 1000.0f, 200.0f, 150.0f };
+    static const ParameterMetadata mbHighCrossover = { "mbHighXover", "Multiband High Crossover", 500.0f, 16000.0f, 2000.0f, 3000.0f };
+
+    static const ParameterMetadata mbThreshold[numCompressorBands] = {
+        { "mbLowThreshold",  "Multiband Low Threshold",  -60.0f, 0.0f, 0.0f },
+        { "mbMidThreshold",  "Multiband Mid Threshold",  -60.0f, 0.0f, 0.0f },
+        { "mbHighThreshold", "Multiband High Threshold", -60.0f, 0.0f, 0.0f }
+    };
+
+    static const ParameterMetadata mbRatio[numCompressorBands] = {
+        { "mbLowRatio",  "Multiband Low Ratio",  1.0f, 20.0f, 1.0f, 4.0f },
+        { "mbMidRatio",  "Multiband Mid Ratio",  1.0f, 20.0f, 1.0f, 4.0f },
+        { "mbHighRatio", "Multiband High Ratio", 1.0f, 20.0f, 1.0f, 4.0f }
+    };
+
+    static const ParameterMetadata mbAttack = { "mbAttack", "Multiband Attack", 0.1f, 100.0f, 10.0f, 10.0f };
+    static const ParameterMetadata mbRelease = { "mbRelease", "Multiband Release", 10.0f, 1000.0f, 100.0f, 150.0f };
+
+    //==============================================================================
+    // Voices
+    static const ParameterMetadata drift = { "drift", "Voice Drift", 0.0f, 1.0f, 0.0f };
+
+    //==============================================================================
+    // Loudness normalisation, steered by the analyser's short-term loudness
+    static const ParameterMetadata loudnessNormalise = { "loudnessNorm", "Loudness Normalise", 0.0f, 1.0f, 0.0f };
+    static const ParameterMetadata loudnessTarget = { "loudnessTarget", "Loudness Target", -36.0f, -6.0f, -14.0f };
+
+    //==============================================================================
+    // True-peak lookahead limiter at the end of the chain; switching it changes the latency
+    static const ParameterMetadata limiterEnabled = { "limiterOn", "Limiter On", 0.0f, 1.0f, 0.0f };
+    static const ParameterMetadata limiterCeiling = { "limiterCeiling", "Limiter Ceiling", -12.0f, 0.0f, -1.0f };
+    static const ParameterMetadata limiterRelease = { "limiterRelease", "Limiter Release", 10.0f, 1000.0f, 100.0f, 150.0f };
 }
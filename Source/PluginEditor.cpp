@@ -8,6 +8,10 @@ VstTestPlaygroundAudioProcessorEditor::VstTestPlaygroundAudioProcessorEditor (Vs
 {
     setLookAndFeel(&customLookAndFeel);
 
+    // The children are opaque and cover the editor, so its background is only
+    // painted when the whole window is
+    setOpaque(true);
+
     // Configure WebView2 with proper backend and user data folder
     auto options = juce::WebBrowserComponent::Options()
         .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
@@ -21,8 +25,16 @@ VstTestPlaygroundAudioProcessorEditor::VstTestPlaygroundAudioProcessorEditor (Vs
         .withNativeIntegrationEnabled()
         .withKeepPageLoadedWhenBrowserIsHidden();
 
-    webView = std::make_unique<WebView>(options);
-    addAndMakeVisible(webView.get());
+    // Without a usable WebView the native controls are the whole UI
+    if (juce::WebBrowserComponent::areOptionsSupported(options))
+    {
+        webView = std::make_unique<WebView>(options);
+        addAndMakeVisible(webView.get());
+    }
+
+    nativeControls = std::make_unique<NativeControls>(processorRef);
+    addChildComponent(nativeControls.get());
+    nativeControls->setVisible(webView == nullptr);
 
     // Set up WebSliderRelay for proper DAW automation
     gainRelay = std::make_unique<juce::WebSliderRelay>(Params::gain.id);
@@ -36,6 +48,7 @@ VstTestPlaygroundAudioProcessorEditor::~VstTestPlaygroundAudioProcessorEditor()
 {
     processorRef.apvts.removeParameterListener(Params::gain.id, this);
     gainRelay.reset();
+    nativeControls.reset();
     webView.reset();
     setLookAndFeel(nullptr);
 }
@@ -49,6 +62,8 @@ void VstTestPlaygroundAudioProcessorEditor::resized()
 {
     if (webView)
         webView->setBounds(getLocalBounds());
+
+    nativeControls->setBounds(getLocalBounds());
 }
 
 void VstTestPlaygroundAudioProcessorEditor::parameterChanged(const juce::String& parameterID, float newValue)
@@ -56,4 +71,20 @@ void VstTestPlaygroundAudioProcessorEditor::parameterChanged(const juce::String&
     // Parameter changes are automatically handled by WebSliderRelay
     // This method can be used for additional UI updates if needed
     juce::ignoreUnused(parameterID, newValue);
-}
\ No newline at end of file
+}
+
+void VstTestPlaygroundAudioProcessorEditor::setNativeControlsVisible(bool shouldBeVisible)
+{
+    nativeControls->setVisible(shouldBeVisible || webView == nullptr);
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* VstTestPlaygroundAudioProcessor::createEditor()
+{
+    return new VstTestPlaygroundAudioProcessorEditor(*this);
+}
+
+bool VstTestPlaygroundAudioProcessor::hasEditor() const
+{
+    return true;
+}
@@ -3,6 +3,7 @@
 #include "PluginProcessor.h"
 #include "CustomLookAndFeel.h"
 #include "WebView.h"
+#include "NativeControls.h"
 
 /**
     The editor for the VST plugin.
@@ -26,6 +27,13 @@ public:
     */
     void parameterChanged(const juce::String& parameterID, float newValue) override;
 
+    /**
+        Shows the native controls over the web UI, or hides them again. They
+        are always shown when this platform can't host the WebView.
+    */
+    void setNativeControlsVisible(bool shouldBeVisible);
+    bool areNativeControlsVisible() const noexcept { return nativeControls->isVisible(); }
+
 private:
     //==============================================================================
     VstTestPlaygroundAudioProcessor& processorRef; /**< A reference to the audio processor. */
@@ -34,6 +42,7 @@ private:
 
     std::unique_ptr<WebView> webView; /**< The web view that displays the UI. */
     std::unique_ptr<juce::WebSliderRelay> gainRelay; /**< Relays parameter changes to the web view. */
+    std::unique_ptr<NativeControls> nativeControls; /**< The native knob and meters, for fallback or overlay. */
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VstTestPlaygroundAudioProcessorEditor)
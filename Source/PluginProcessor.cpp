@@ -1,6 +1,14 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
 #include "Params.h"
+#include "ChannelKernels.h"
+#include "ContentHash.h"
+
+namespace
+{
+    constexpr float maxLoudnessCorrectionDB = 24.0f;
+    constexpr float maxLoudnessErrorDB = 6.0f;      /**< Errors beyond this step no faster, e.g. right after a silence. */
+    constexpr float loudnessCorrectionRate = 0.3f;  /**< dB per second per dB of error. */
+}
 
 //==============================================================================
 VstTestPlaygroundAudioProcessor::VstTestPlaygroundAudioProcessor()
@@ -10,11 +18,43 @@ VstTestPlaygroundAudioProcessor::VstTestPlaygroundAudioProcessor()
                          .withInput("Input", juce::AudioChannelSet::stereo(), true)
 #endif
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                         .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
                          ),
-      apvts(*this, &undoManager, "Parameters", createParameterLayout())
+      apvts(*this, &undoManager, "Parameters", createParameterLayout()),
+      stateSnapshot(apvts)
 {
     gainParameter = apvts.getRawParameterValue(Params::GAIN_ID);
+
+    for (int i = 0; i < Params::numEqBands; ++i)
+    {
+        eqFrequencyParameters[i] = apvts.getRawParameterValue(Params::eqFrequency[i].id);
+        eqGainParameters[i] = apvts.getRawParameterValue(Params::eqGain[i].id);
+        eqQParameters[i] = apvts.getRawParameterValue(Params::eqQ[i].id);
+    }
+
+    mbEnabledParameter = apvts.getRawParameterValue(Params::mbEnabled.id);
+    mbLowCrossoverParameter = apvts.getRawParameterValue(Params::mbLowCrossover.id);
+    mbHighCrossoverParameter = apvts.getRawParameterValue(Params::mbHighCrossover.id);
+
+    for (int i = 0; i < Params::numCompressorBands; ++i)
+    {
+        mbThresholdParameters[i] = apvts.getRawParameterValue(Params::mbThreshold[i].id);
+        mbRatioParameters[i] = apvts.getRawParameterValue(Params::mbRatio[i].id);
+    }
+
+    mbAttackParameter = apvts.getRawParameterValue(Params::mbAttack.id);
+    mbReleaseParameter = apvts.getRawParameterValue(Params::mbRelease.id);
+    driftParameter = apvts.getRawParameterValue(Params::drift.id);
+    loudnessNormaliseParameter = apvts.getRawParameterValue(Params::loudnessNormalise.id);
+    loudnessTargetParameter = apvts.getRawParameterValue(Params::loudnessTarget.id);
+    limiterEnabledParameter = apvts.getRawParameterValue(Params::limiterEnabled.id);
+    limiterCeilingParameter = apvts.getRawParameterValue(Params::limiterCeiling.id);
+    limiterReleaseParameter = apvts.getRawParameterValue(Params::limiterRelease.id);
+}
+
+VstTestPlaygroundAudioProcessor::~VstTestPlaygroundAudioProcessor()
+{
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout VstTestPlaygroundAudioProcessor::createParameterLayout()
@@ -31,57 +71,297 @@ juce::AudioProcessorValueTreeState::ParameterLayout VstTestPlaygroundAudioProces
             1.0f),
         Params::gain.defaultValue));
 
+    auto addFloat = [&layout] (const Params::ParameterMetadata& p, float interval)
+    {
+        juce::NormalisableRange<float> range(p.minValue, p.maxValue, interval, 1.0f);
+
+        if (p.skewCentre > 0.0f)
+            range.setSkewForCentre(p.skewCentre);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(p.id, p.name, range, p.defaultValue));
+    };
+
+    for (int i = 0; i < Params::numEqBands; ++i)
+    {
+        addFloat(Params::eqFrequency[i], 0.1f);
+        addFloat(Params::eqGain[i], 0.01f);
+        addFloat(Params::eqQ[i], 0.001f);
+    }
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        Params::mbEnabled.id,
+        Params::mbEnabled.name,
+        Params::mbEnabled.defaultValue > 0.5f));
+
+    addFloat(Params::mbLowCrossover, 0.1f);
+    addFloat(Params::mbHighCrossover, 0.1f);
+
+    for (int i = 0; i < Params::numCompressorBands; ++i)
+    {
+        addFloat(Params::mbThreshold[i], 0.01f);
+        addFloat(Params::mbRatio[i], 0.01f);
+    }
+
+    addFloat(Params::mbAttack, 0.01f);
+    addFloat(Params::mbRelease, 0.1f);
+    addFloat(Params::drift, 0.001f);
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        Params::loudnessNormalise.id,
+        Params::loudnessNormalise.name,
+        Params::loudnessNormalise.defaultValue > 0.5f));
+
+    addFloat(Params::loudnessTarget, 0.1f);
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        Params::limiterEnabled.id,
+        Params::limiterEnabled.name,
+        Params::limiterEnabled.defaultValue > 0.5f));
+
+    addFloat(Params::limiterCeiling, 0.01f);
+    addFloat(Params::limiterRelease, 0.1f);
+
     return layout;
 }
 
 void VstTestPlaygroundAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
+    rateConverter.prepare(sampleRate, internalSampleRate, getMainBusNumOutputChannels(), samplesPerBlock);
+    quantumAdapter.prepare(getMainBusNumOutputChannels(), rateConverter.getMaxProcessingBlockSize());
+
+    // Everything past this point is designed for the processing rate only
+    const auto processingRate = rateConverter.getProcessingRate();
+    const auto maxBlockSize = quantumAdapter.getMaxProcessingBlockSize();
+
+    gainRampSize = juce::jmax(1, maxBlockSize);
+    gainRamp.allocate((size_t) gainRampSize, true);
+
+    // Measures the host-rate output, before any processing-rate detour
+    analyser.setAnalyseInline(deterministicRender);
+    analyser.prepare(sampleRate, getMainBusNumOutputChannels(), samplesPerBlock);
+    loudnessCorrectionDB = 0.0f;
 
-    gain.prepare(spec);
-    gain.setRampDurationSeconds(0.05);
-    
     // Initialize gain to current parameter value
     previousGainDB = gainParameter->load();
-    gain.setGainDecibels(previousGainDB);
+    gain.reset(processingRate, 0.05);
+    gain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(previousGainDB));
+
+    preparsedMidi.reset();
+    voices.prepare(processingRate, maxBlockSize);
+    voices.setDriftSeed(std::nullopt);
+    driftSeedVersion = 0; // the snapshot's versions start at 1, so this always seeds
+    updateDriftSeed();
+    sampler.prepare(processingRate, maxBlockSize); // reloads the sample if its preload length changes
+    sampler.setWaitForDisk(deterministicRender);
+    midiTimeScale = processingRate / sampleRate;
+
+    // Set the targets first so prepare() starts the stages on them rather than gliding there
+    const auto numChannels = getMainBusNumOutputChannels();
+    updateFilterParameters();
+    equaliser.prepare(processingRate, maxBlockSize, numChannels);
+    multibandCompressor.prepare(processingRate, maxBlockSize, numChannels);
+    limiter.prepare(processingRate, maxBlockSize, numChannels);
+
+    // The quantum FIFO and the limiter delay by processing samples, which only approximately match host samples.
+    // The limiter's delay stays in the path while it's switched off, so the latency only changes here.
+    setLatencySamples(rateConverter.getLatencySamples()
+                      + juce::roundToInt((quantumAdapter.getLatencySamples() + limiter.getLatencySamples()) * sampleRate / processingRate));
 }
 
-void VstTestPlaygroundAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void VstTestPlaygroundAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
+    const ExecutionContext::ScopedCycle cycle(audioThreadScope); // also flushes denormals
 
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    preparsedMidi.parse(midiMessages, buffer.getNumSamples());
+    nextMidiEvent = preparsedMidi.begin();
+    internalBlockPosition = -quantumAdapter.getNumBuffered(); // the first quantum starts in the previous block
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    // Only the main bus is processed; the sidechain is read-only input that
+    // shares its channels with the first outputs and must not leak through.
+    auto mainBus = getBusBuffer(buffer, false, 0);
+
+   #if JucePlugin_IsSynth
+    const auto numMainInputChannels = 0;
+   #else
+    const auto numMainInputChannels = getMainBusNumInputChannels();
+   #endif
+
+    for (auto i = numMainInputChannels; i < mainBus.getNumChannels(); ++i)
+        mainBus.clear (i, 0, mainBus.getNumSamples());
 
     // Only update gain when parameter changes (avoid repeated calculations)
-    float currentGainDB = gainParameter->load();
+    float currentGainDB = gainParameter->load() + updateLoudnessCorrection(buffer.getNumSamples());
     if (!juce::approximatelyEqual(currentGainDB, previousGainDB))
     {
-        gain.setGainDecibels(currentGainDB);
+        gain.setTargetValue(juce::Decibels::decibelsToGain(currentGainDB));
         previousGainDB = currentGainDB;
     }
 
-    juce::dsp::AudioBlock<float> block (buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
-    gain.process(context);
+    updateFilterParameters();
+    voices.setDrift(driftParameter->load());
+    updateDriftSeed();
+
+    rateConverter.process(mainBus, [this] (juce::AudioBuffer<float>& block)
+    {
+        quantumAdapter.process(block, [this] (juce::AudioBuffer<float>& quantum) { processInternal(quantum); });
+    });
+
+    analyser.push(mainBus);
+
+    // Peaks for the editor's meters, held until it reads them
+    for (int ch = 0; ch < juce::jmin(2, mainBus.getNumChannels()); ++ch)
+    {
+        const auto peak = mainBus.getMagnitude(ch, 0, mainBus.getNumSamples());
+        auto previous = outputPeaks[ch].load();
+
+        while (peak > previous && ! outputPeaks[ch].compare_exchange_weak(previous, peak)) {}
+    }
+
+    // Events the resampled blocks or the last full quantum didn't reach still
+    // have to land, e.g. note-offs; they take effect at the next quantum's start
+    for (; nextMidiEvent != preparsedMidi.end(); ++nextMidiEvent)
+    {
+        voices.handleEvent(*nextMidiEvent, preparsedMidi.getZoneLayout());
+        sampler.handleEvent(*nextMidiEvent);
+    }
+}
+
+void VstTestPlaygroundAudioProcessor::processInternal(juce::AudioBuffer<float>& block)
+{
+    renderVoices(block);
+    applyGain(block);
+    equaliser.process(block);
+    multibandCompressor.process(block);
+    limiter.process(block);
+}
+
+void VstTestPlaygroundAudioProcessor::renderVoices(juce::AudioBuffer<float>& block)
+{
+    const auto numSamples = block.getNumSamples();
+    int position = 0;
+
+    for (; nextMidiEvent != preparsedMidi.end(); ++nextMidiEvent)
+    {
+        const auto eventPosition = (int) (nextMidiEvent->sampleOffset * midiTimeScale) - internalBlockPosition;
+
+        if (eventPosition >= numSamples)
+            break;
+
+        if (eventPosition > position)
+        {
+            voices.render(block, position, eventPosition - position);
+            sampler.render(block, position, eventPosition - position);
+            position = eventPosition;
+        }
+
+        voices.handleEvent(*nextMidiEvent, preparsedMidi.getZoneLayout());
+        sampler.handleEvent(*nextMidiEvent);
+    }
+
+    voices.render(block, position, numSamples - position);
+    sampler.render(block, position, numSamples - position);
+    internalBlockPosition += numSamples;
+}
+
+void VstTestPlaygroundAudioProcessor::updateFilterParameters()
+{
+    // The stages only react when a target actually changes
+    for (int i = 0; i < Params::numEqBands; ++i)
+        equaliser.setBand(i, eqFrequencyParameters[i]->load(), eqGainParameters[i]->load(), eqQParameters[i]->load());
+
+    multibandCompressor.setEnabled(mbEnabledParameter->load() > 0.5f);
+    multibandCompressor.setCrossovers(mbLowCrossoverParameter->load(), mbHighCrossoverParameter->load());
+
+    for (int i = 0; i < Params::numCompressorBands; ++i)
+        multibandCompressor.setBand(i, mbThresholdParameters[i]->load(), mbRatioParameters[i]->load());
+
+    multibandCompressor.setTimes(mbAttackParameter->load(), mbReleaseParameter->load());
+
+    limiter.setEnabled(limiterEnabledParameter->load() > 0.5f);
+    limiter.setCeiling(limiterCeilingParameter->load());
+    limiter.setRelease(limiterReleaseParameter->load());
+}
+
+std::vector<ExecutionContext::ThreadStats> VstTestPlaygroundAudioProcessor::getThreadStats() const
+{
+    auto stats = executionContext->getStats();
+    stats.push_back(audioThreadScope.getStats());
+    return stats;
+}
+
+float VstTestPlaygroundAudioProcessor::updateLoudnessCorrection(int numSamples) noexcept
+{
+    if (loudnessNormaliseParameter->load() < 0.5f)
+        return loudnessCorrectionDB = 0.0f;
+
+    // Hold through silence rather than turning it up
+    const auto loudness = analyser.getShortTermLoudness();
+
+    if (loudness > SpectrumAnalyser::silenceLufs)
+    {
+        const auto error = juce::jlimit(-maxLoudnessErrorDB, maxLoudnessErrorDB, loudnessTargetParameter->load() - loudness);
+        const auto seconds = (float) (numSamples / getSampleRate());
+        loudnessCorrectionDB = juce::jlimit(-maxLoudnessCorrectionDB, maxLoudnessCorrectionDB,
+                                            loudnessCorrectionDB + error * loudnessCorrectionRate * seconds);
+    }
+
+    return loudnessCorrectionDB;
 }
 
-juce::AudioProcessorEditor* VstTestPlaygroundAudioProcessor::createEditor()
+void VstTestPlaygroundAudioProcessor::applyGain(juce::AudioBuffer<float>& mainBus)
 {
-    return new VstTestPlaygroundAudioProcessorEditor(*this);
+    auto* const* channels = mainBus.getArrayOfWritePointers();
+    const auto numChannels = mainBus.getNumChannels();
+    const auto numSamples = mainBus.getNumSamples();
+
+    ChannelKernels::dispatch(numChannels, [&] (auto channelCount)
+    {
+        constexpr int N = decltype (channelCount)::value;
+
+        // A full quantum gets kernels compiled for its exact length
+        ChannelKernels::dispatchLength<processingQuantum>(numSamples, [&] (auto sampleCount)
+        {
+            constexpr int L = decltype (sampleCount)::value;
+
+            if (! gain.isSmoothing())
+            {
+                ChannelKernels::applyGain<N, L>(channels, numChannels, gain.getTargetValue(), numSamples);
+                return;
+            }
+
+            if constexpr (L != ChannelKernels::dynamicSampleCount)
+            {
+                jassert(gainRampSize >= L);
+
+                for (int i = 0; i < L; ++i)
+                    gainRamp[i] = gain.getNextValue();
+
+                ChannelKernels::applyGainRamp<N, L>(channels, numChannels, gainRamp, numSamples);
+                return;
+            }
+
+            // Hosts may send more than samplesPerBlock, so ramp in scratch-sized chunks.
+            for (int start = 0; start < numSamples; start += gainRampSize)
+            {
+                const auto num = juce::jmin(gainRampSize, numSamples - start);
+
+                for (int i = 0; i < num; ++i)
+                    gainRamp[i] = gain.getNextValue();
+
+                float* offsetChannels[maxOutputChannels];
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    offsetChannels[ch] = channels[ch] + start;
+
+                ChannelKernels::applyGainRamp<N>(offsetChannels, numChannels, gainRamp, num);
+            }
+        });
+    });
 }
 
 void VstTestPlaygroundAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    stateSnapshot.writeTo(destData);
 }
 
 void VstTestPlaygroundAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
@@ -89,8 +369,121 @@ void VstTestPlaygroundAudioProcessor::setStateInformation(const void* data, int
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+            // Queued, not loaded: the host gets control back straight away
+            const auto path = xmlState->getStringAttribute(sampleFileProperty);
+            const auto file = juce::File::isAbsolutePath(path) ? juce::File(path) : juce::File();
+
+            if (file != sampleFile)
+                loadSample(file);
+        }
+    }
+}
+
+void VstTestPlaygroundAudioProcessor::loadSample(const juce::File& file)
+{
+    sampleFile = file;
+
+    // The path alone would miss a sample re-recorded in place. Published
+    // before the property bumps the snapshot's version, so the audio thread's
+    // re-seed never sees the new version with the old hash.
+    sampleFileHash = file == juce::File() ? 0
+                                          : ContentHash().add(file.getFullPathName())
+                                                         .add(file.getSize())
+                                                         .add(file.getLastModificationTime().toMilliseconds())
+                                                         .get();
+    stateSnapshot.setProperty(sampleFileProperty, file.getFullPathName());
+
+    // Only the attack is read now; the sampler streams the rest while notes play
+    const auto generation = sampler.setSample(file);
+
+    // A deterministic render can't start before the sample is there, but needn't wait for other instances' loads
+    if (deterministicRender && generation != 0)
+        assetLoader->waitUntilLoaded(sampleSlot, generation, 30000);
+}
+
+void VstTestPlaygroundAudioProcessor::updateDriftSeed()
+{
+    // Parameter changes, restores and new samples all bump the snapshot's version
+    if (const auto version = stateSnapshot.getVersion(); deterministicRender && version != driftSeedVersion)
+    {
+        driftSeedVersion = version;
+        voices.setDriftSeed(getStateHash());
+    }
+}
+
+juce::uint64 VstTestPlaygroundAudioProcessor::getStateHash() const
+{
+    ContentHash hash;
+    hash.add(renderVersion).add(deterministicRender);
+    hash.add(getSampleRate()).add(getBlockSize()).add(internalSampleRate).add(getMainBusNumOutputChannels());
+    hash.add(processingQuantum).add(quantumAdapter.usesFifo);
+
+    for (auto* parameter : getParameters())
+        hash.add(parameter->getValue());
+
+    // Taken by loadSample(), so the audio thread never touches the file system
+    hash.add(sampleFileHash.load());
+
+    return hash.get();
+}
+
+juce::uint64 VstTestPlaygroundAudioProcessor::getRenderCacheKey(const juce::AudioBuffer<float>& input,
+                                                               const juce::MidiBuffer& midi) const
+{
+    return ContentHash(getStateHash()).add(input).add(midi).get();
+}
+
+bool VstTestPlaygroundAudioProcessor::isSupportedOutputLayout(const juce::AudioChannelSet& set)
+{
+    static const juce::Array<juce::AudioChannelSet> supported {
+        juce::AudioChannelSet::mono(),
+        juce::AudioChannelSet::stereo(),
+        juce::AudioChannelSet::createLCR(),
+        juce::AudioChannelSet::quadraphonic(),
+        juce::AudioChannelSet::create5point0(),
+        juce::AudioChannelSet::create5point1(),
+        juce::AudioChannelSet::create6point0(),
+        juce::AudioChannelSet::create6point1(),
+        juce::AudioChannelSet::create7point0(),
+        juce::AudioChannelSet::create7point1(),
+        juce::AudioChannelSet::create7point0point2(),
+        juce::AudioChannelSet::create7point1point2(),
+        juce::AudioChannelSet::create7point0point4(),
+        juce::AudioChannelSet::create7point1point4()
+    };
+
+    return set.size() <= maxOutputChannels && supported.contains(set);
+}
+
+bool VstTestPlaygroundAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || ! isSupportedOutputLayout(mainOutput))
+        return false;
+
+   #if ! JucePlugin_IsSynth
+    // Effects process in place, so the main input has to mirror the output.
+    if (layouts.getMainInputChannelSet() != mainOutput)
+        return false;
+   #endif
+
+    if (sidechainBusIndex < layouts.inputBuses.size())
+    {
+        const auto& sidechain = layouts.getChannelSet(true, sidechainBusIndex);
+
+        if (! sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
+    return true;
 }
 
 //==============================================================================
@@ -2,6 +2,28 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "ParameterSnapshot.h"
+#include "InternalRateConverter.h"
+#include "FixedBlockAdapter.h"
+#include "EqualiserStage.h"
+#include "MultibandCompressor.h"
+#include "LookaheadLimiter.h"
+#include "PreparsedMidiBuffer.h"
+#include "MpeVoicePool.h"
+#include "StreamingSampler.h"
+#include "SpectrumAnalyser.h"
+#include "ExecutionContext.h"
+#include "Params.h"
+
+/** The DSP's fixed processing quantum in samples (e.g. 32 or 64), or 0 to process host blocks as they come. */
+#ifndef VSTP_PROCESSING_QUANTUM
+ #define VSTP_PROCESSING_QUANTUM 0
+#endif
+
+/** 1 to reach the quantum through a FIFO (adds a quantum of latency), 0 to split host blocks. */
+#ifndef VSTP_QUANTUM_FIFO
+ #define VSTP_QUANTUM_FIFO 1
+#endif
 
 /**
     The main audio processor for the VST plugin.
@@ -20,6 +42,11 @@ public:
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
+    /**
+        Defined on the editor side, so the core has no GUI code in it:
+        PluginEditor.cpp creates the WebView editor, and HeadlessEditor.cpp,
+        which headless targets link instead, returns nullptr.
+    */
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
@@ -38,11 +65,126 @@ public:
     void changeProgramName (int index, const juce::String& newName) override;
 
     //==============================================================================
+    /**
+        Serialises the lock-free parameter snapshot. Safe to call from any host
+        thread; it never copies or locks the APVTS ValueTree.
+    */
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
+    //==============================================================================
+    /**
+        Runs the DSP at a fixed rate (e.g. 48000) whatever the host rate, with
+        polyphase resampling in and out and the added delay reported as latency.
+        Pass 0 to process at the host rate. Takes effect on the next prepareToPlay().
+    */
+    void setInternalSampleRate (double newRate) noexcept { internalSampleRate = newRate; }
+    double getInternalSampleRate() const noexcept { return internalSampleRate; }
+
+    /**
+        The compile-time processing quantum (VSTP_PROCESSING_QUANTUM). The DSP
+        chain runs in blocks of exactly this many samples at the processing
+        rate, or at most this many when splitting, with the FIFO's delay added
+        to the reported latency. 0 when disabled.
+    */
+    static constexpr int processingQuantum = VSTP_PROCESSING_QUANTUM;
+
+    //==============================================================================
+    /**
+        Deterministic render mode, for offline renders whose results are cached.
+        Voice drift is seeded from getStateHash() and each note's ID rather than
+        a free-running generator, and re-seeded at the next block whenever the
+        state changes. loadSample() and setStateInformation() wait for the
+        sample to load, and the sampler waits for the disk instead of playing
+        silence. The same state and input then always give bit-identical
+        output. Never use it for realtime playback. Takes effect on the next
+        prepareToPlay().
+    */
+    void setDeterministicRender (bool shouldBeDeterministic) noexcept { deterministicRender = shouldBeDeterministic; }
+    bool isDeterministicRender() const noexcept { return deterministicRender; }
+
+    /**
+        A hash of everything other than the input that decides the output:
+        parameter values, the sample's path, size and date when it was loaded,
+        the render settings and renderVersion. Cheap enough to call per render
+        or from the audio thread; it reads the parameters directly rather than
+        serialising the state, and never touches the file system.
+    */
+    juce::uint64 getStateHash() const;
+
+    /**
+        A render farm cache key for processing input and midi from the current
+        state in deterministic mode. Pass a whole stem, or chain blocks through
+        a ContentHash seeded with getStateHash() yourself. Host automation
+        isn't part of the key.
+    */
+    juce::uint64 getRenderCacheKey (const juce::AudioBuffer<float>& input, const juce::MidiBuffer& midi) const;
+
+    /** Bump whenever a change alters rendered output, so cached renders are invalidated. */
+    static constexpr int renderVersion = 3;
+
+    /**
+        The current block's MIDI, decoded once at the top of processBlock().
+        Offsets are in host samples. Voice, modulation and arpeggiator code
+        should read this rather than iterating the MidiBuffer again.
+    */
+    const PreparsedMidiBuffer& getPreparsedMidi() const noexcept { return preparsedMidi; }
+
+    //==============================================================================
+    /**
+        Starts loading a sample in the background and returns at once; an empty
+        File unloads it. The path is saved with the state, and
+        setStateInformation() reloads it the same way, so restoring a session
+        or switching presets never waits on disk.
+    */
+    void loadSample (const juce::File& file);
+
+    /** The resident attack of the loaded sample, for the audio thread to read with AssetSlot::ScopedRead. */
+    AssetSlot<AudioAsset>& getSampleSlot() noexcept { return sampleSlot; }
+
+    /** Shared by every instance in the process. */
+    AssetLoader& getAssetLoader() noexcept { return *assetLoader; }
+
+    /** Plays the loaded sample on incoming notes, streaming it from disk. */
+    StreamingSampler& getSampler() noexcept { return sampler; }
+
+    /**
+        The highest absolute output sample on a channel (0 or 1) since the
+        previous call, which resets it. For meters on the message thread.
+    */
+    float takeOutputPeak (int channel) noexcept { return outputPeaks[juce::jlimit(0, 1, channel)].exchange(0.0f); }
+
+    /**
+        The output's spectrum and loudness, measured on a background thread.
+        The editor is its one results reader. In deterministic render mode it
+        analyses inline, so loudness normalisation stays deterministic too.
+    */
+    SpectrumAnalyser& getAnalyser() noexcept { return analyser; }
+
+    /**
+        Stats for this instance's audio thread in processBlock(), and for every
+        worker in the process that feeds the DSP: the streamers, analysers and
+        asset loaders shared by every instance. All of them run with denormals
+        flushed to zero. Not for the audio thread.
+    */
+    std::vector<ExecutionContext::ThreadStats> getThreadStats() const;
+
+    /** The state attribute holding the sample path. */
+    static inline const juce::Identifier sampleFileProperty { "sampleFile" };
+
+    //==============================================================================
+    /** The largest main output layout we accept (7.1.4). */
+    static constexpr int maxOutputChannels = 12;
+
+    /** Index of the optional sidechain among the input buses. */
+#if JucePlugin_IsSynth
+    static constexpr int sidechainBusIndex = 0;
+#else
+    static constexpr int sidechainBusIndex = 1;
+#endif
+
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts; /**< Manages the plugin's parameters. */
 
@@ -53,11 +195,98 @@ private:
     */
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    /**
+        Returns true if the set is one of the output layouts we ship kernels for:
+        mono, stereo and the standard surround/immersive sets up to 7.1.4.
+    */
+    static bool isSupportedOutputLayout (const juce::AudioChannelSet& set);
+
+    /** The DSP chain, running at rateConverter's processing rate in quantumAdapter's blocks. */
+    void processInternal (juce::AudioBuffer<float>& block);
+
+    /**
+        Adds the synth and sampler voices to the block, applying this block's MIDI events at
+        their offsets scaled to the processing rate. With a fixed internal rate
+        the timing is approximate to within the resampler's buffering.
+    */
+    void renderVoices (juce::AudioBuffer<float>& block);
+
+    /** Pushes the current EQ, dynamics and limiter parameter values to their stages. */
+    void updateFilterParameters();
+
+    /**
+        In deterministic mode, re-seeds the voices' drift from getStateHash()
+        whenever the state has changed since the last seed, so the seed always
+        matches what getRenderCacheKey() hashes.
+    */
+    void updateDriftSeed();
+
+    /**
+        Applies the smoothed gain to the main output bus, dispatching to the
+        kernel specialised for its channel count.
+    */
+    void applyGain (juce::AudioBuffer<float>& mainBus);
+
+    /**
+        With loudness normalisation on, steps the correction towards the target
+        by the analyser's short-term loudness and returns it in dB; otherwise 0.
+        The analyser measures the corrected output, so the correction moves
+        slowly enough not to hunt over the 3 second window.
+    */
+    float updateLoudnessCorrection (int numSamples) noexcept;
+
+    juce::SharedResourcePointer<ExecutionContext> executionContext; /**< FTZ/DAZ and stats for every thread. */
+    ExecutionContext::ThreadScope audioThreadScope { "Audio", ExecutionContext::Role::audio }; /**< Whichever host thread calls processBlock(); its stats stay with this instance. */
     juce::UndoManager undoManager; /**< Manages undo/redo operations. */
-    juce::dsp::Gain<float> gain; /**< The gain processor. */
+    ParameterSnapshot stateSnapshot; /**< Lock-free copy of the parameter values for getStateInformation. */
+    InternalRateConverter rateConverter; /**< Resamples around the DSP when a fixed internal rate is set. */
+    double internalSampleRate = 0.0; /**< The fixed DSP rate, or 0 to follow the host. */
+    FixedBlockAdapter<processingQuantum, VSTP_QUANTUM_FIFO != 0> quantumAdapter; /**< Cuts the processing-rate blocks into quanta. */
+    bool deterministicRender = false; /**< See setDeterministicRender(). */
+    juce::uint32 driftSeedVersion = 0; /**< The state snapshot's version the drift seed was taken at. */
+    juce::SmoothedValue<float> gain; /**< The linear gain, ramped over 50ms. */
+    juce::HeapBlock<float> gainRamp; /**< Scratch buffer holding one sub-block of ramped gain values. */
+    int gainRampSize = 0; /**< The number of samples gainRamp can hold. */
     std::atomic<float>* gainParameter = nullptr; /**< A pointer to the gain parameter. */
     float previousGainDB = 0.0f; /**< The previous gain value in dB. */
 
+    PreparsedMidiBuffer preparsedMidi; /**< This block's MIDI as typed events. */
+    MpeVoicePool voices; /**< The synth voices, with MPE per-note expression. */
+    const PreparsedMidiBuffer::Event* nextMidiEvent = nullptr; /**< The first event renderVoices() hasn't applied yet. */
+    double midiTimeScale = 1.0; /**< Processing samples per host sample. */
+    int internalBlockPosition = 0; /**< Processing samples rendered so far in this host block; negative while a FIFO quantum catches up. */
+
+    AssetSlot<AudioAsset> sampleSlot; /**< Declared before the sampler, which takes it back from the loader when it goes. */
+    juce::SharedResourcePointer<AssetLoader> assetLoader; /**< One loader and its workers for every instance. */
+    StreamingSampler sampler { *assetLoader, sampleSlot };
+    juce::File sampleFile; /**< The most recently requested sample. Message thread only. */
+    std::atomic<juce::uint64> sampleFileHash { 0 }; /**< The sample's path, size and date, hashed by loadSample() for getStateHash(); 0 with no sample. */
+
+    std::atomic<float> outputPeaks[2] {}; /**< Raised by processBlock(), reset by takeOutputPeak(). */
+    SpectrumAnalyser analyser; /**< Fed the output at the end of processBlock(). */
+    float loudnessCorrectionDB = 0.0f; /**< Added to the gain parameter while normalising. */
+
+    EqualiserStage equaliser; /**< Parametric EQ after the gain stage. */
+    MultibandCompressor multibandCompressor; /**< Three-band compressor after the EQ. */
+    LookaheadLimiter limiter; /**< True-peak limiter, last in the chain. */
+
+    std::atomic<float>* eqFrequencyParameters[Params::numEqBands] {};
+    std::atomic<float>* eqGainParameters[Params::numEqBands] {};
+    std::atomic<float>* eqQParameters[Params::numEqBands] {};
+    std::atomic<float>* mbEnabledParameter = nullptr;
+    std::atomic<float>* mbLowCrossoverParameter = nullptr;
+    std::atomic<float>* mbHighCrossoverParameter = nullptr;
+    std::atomic<float>* mbThresholdParameters[Params::numCompressorBands] {};
+    std::atomic<float>* mbRatioParameters[Params::numCompressorBands] {};
+    std::atomic<float>* mbAttackParameter = nullptr;
+    std::atomic<float>* mbReleaseParameter = nullptr;
+    std::atomic<float>* driftParameter = nullptr;
+    std::atomic<float>* loudnessNormaliseParameter = nullptr;
+    std::atomic<float>* loudnessTargetParameter = nullptr;
+    std::atomic<float>* limiterEnabledParameter = nullptr;
+    std::atomic<float>* limiterCeilingParameter = nullptr;
+    std::atomic<float>* limiterReleaseParameter = nullptr;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VstTestPlaygroundAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "PolyphaseResampler.h"
+#include <map>
+
+//==============================================================================
+namespace
+{
+    /** Two dot products against neighbouring phases, sharing the history loads. */
+    inline void dotProducts (const float* x, const float* h0, const float* h1, float& result0, float& result1) noexcept
+    {
+        constexpr int lanes = 8;
+        float acc0[lanes] = {};
+        float acc1[lanes] = {};
+
+        for (int k = 0; k < PolyphaseResampler::numTaps; k += lanes)
+        {
+            for (int l = 0; l < lanes; ++l)
+            {
+                acc0[l] += x[k + l] * h0[k + l];
+                acc1[l] += x[k + l] * h1[k + l];
+            }
+        }
+
+        result0 = result1 = 0.0f;
+
+        for (int l = 0; l < lanes; ++l)
+        {
+            result0 += acc0[l];
+            result1 += acc1[l];
+        }
+    }
+
+    double blackmanHarris (double x) noexcept
+    {
+        // x in [-1, 1]
+        const auto pi = juce::MathConstants<double>::pi;
+        return 0.35875 + 0.48829 * std::cos (pi * x) + 0.14128 * std::cos (2.0 * pi * x) + 0.01168 * std::cos (3.0 * pi * x);
+    }
+}
+
+static_assert (PolyphaseResampler::numTaps % 8 == 0, "dotProducts() works in groups of 8 taps");
+
+//==============================================================================
+void PolyphaseResampler::prepare (double sourceRate, double targetRate, int numChannels, int maxInputSamples)
+{
+    jassert (sourceRate > 0.0 && targetRate > 0.0);
+
+    step = sourceRate / targetRate;
+
+    // Cutoff relative to the source Nyquist: just below the lower of the two
+    // Nyquist frequencies, leaving room for the transition band.
+    const auto cutoff = (float) (0.91 * juce::jmin (1.0, targetRate / sourceRate));
+    table = getTable (cutoff);
+
+    history.setSize (numChannels, numTaps + maxInputSamples + 1);
+    reset();
+}
+
+void PolyphaseResampler::reset (double initialPosition)
+{
+    jassert (initialPosition >= 0.0 && initialPosition < 1.0);
+
+    history.clear();
+    numBuffered = 0;
+    position = initialPosition;
+}
+
+int PolyphaseResampler::process (const float* const* input, int numInputSamples, float* const* output, int maxOutputSamples) noexcept
+{
+    jassert (numBuffered + numInputSamples <= history.getNumSamples());
+
+    const auto numChannels = history.getNumChannels();
+    auto* const* buffers = history.getArrayOfWritePointers();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::copy (buffers[ch] + numBuffered, input[ch], numInputSamples);
+
+    numBuffered += numInputSamples;
+
+    const auto* coefficients = table->data();
+    int numProduced = 0;
+
+    while (numProduced < maxOutputSamples)
+    {
+        const auto index = (int) position;
+
+        if (index + numTaps > numBuffered)
+            break;
+
+        const auto phasePosition = (position - index) * numPhases;
+        const auto phase = (int) phasePosition;
+        const auto phaseFraction = (float) (phasePosition - phase);
+
+        const auto* h0 = coefficients + phase * numTaps;
+        const auto* h1 = h0 + numTaps;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float y0, y1;
+            dotProducts (buffers[ch] + index, h0, h1, y0, y1);
+            output[ch][numProduced] = y0 + phaseFraction * (y1 - y0);
+        }
+
+        ++numProduced;
+        position += step;
+    }
+
+    // Drop the history no future output can reach
+    const auto consumed = juce::jmin ((int) position, numBuffered);
+
+    if (consumed > 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::memmove (buffers[ch], buffers[ch] + consumed, sizeof (float) * (size_t) (numBuffered - consumed));
+
+        numBuffered -= consumed;
+        position -= consumed;
+    }
+
+    return numProduced;
+}
+
+//==============================================================================
+std::shared_ptr<const PolyphaseResampler::Table> PolyphaseResampler::getTable (float cutoff)
+{
+    static juce::CriticalSection lock;
+    static std::map<float, std::weak_ptr<const Table>> cache;
+
+    const juce::ScopedLock sl (lock);
+
+    if (auto existing = cache[cutoff].lock())
+        return existing;
+
+    auto created = createTable (cutoff);
+    cache[cutoff] = created;
+    return created;
+}
+
+std::shared_ptr<const PolyphaseResampler::Table> PolyphaseResampler::createTable (float cutoff)
+{
+    // numPhases + 1 rows so phase + 1 is always valid when interpolating
+    auto table = std::make_shared<Table> ((size_t) ((numPhases + 1) * numTaps));
+    const auto halfLength = numTaps / 2.0;
+
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        auto* row = table->data() + phase * numTaps;
+        const auto fraction = (double) phase / numPhases;
+        double sum = 0.0;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            // Distance from the interpolated point, which sits between taps
+            // centreOffset and centreOffset + 1
+            const auto t = k - getCentreOffset() - fraction;
+            const auto x = juce::MathConstants<double>::pi * cutoff * t;
+            const auto sinc = std::abs (t) < 1.0e-9 ? 1.0 : std::sin (x) / x;
+            const auto value = cutoff * sinc * blackmanHarris (juce::jlimit (-1.0, 1.0, t / halfLength));
+
+            row[k] = (float) value;
+            sum += value;
+        }
+
+        // Unity gain at DC for every phase
+        for (int k = 0; k < numTaps; ++k)
+            row[k] = (float) (row[k] / sum);
+    }
+
+    return table;
+}
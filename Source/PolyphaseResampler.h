@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**
+    A streaming multichannel sample-rate converter.
+
+    Uses a windowed-sinc (Blackman-Harris) polyphase table with numPhases
+    sub-sample phases and linear interpolation between neighbouring phases,
+    so any ratio (44.1k <-> 48k, 192k -> 48k, ...) runs from the same table.
+    Tables depend only on the cutoff and are built once and shared between
+    all resamplers that need the same one.
+
+    The inner loop is a pair of numTaps-long dot products over contiguous
+    history and coefficients, written with independent lane accumulators so
+    the compiler vectorises it without fast-math.
+*/
+class PolyphaseResampler
+{
+public:
+    //==============================================================================
+    static constexpr int numTaps = 64;      /**< Filter length per phase; must be a multiple of 8. */
+    static constexpr int numPhases = 256;   /**< Sub-sample resolution of the table. */
+
+    //==============================================================================
+    /** Allocates history for up to maxInputSamples per process() call and builds or fetches the table. */
+    void prepare (double sourceRate, double targetRate, int numChannels, int maxInputSamples);
+
+    /**
+        Clears the history. initialPosition (in source samples, 0 <= x < 1) delays
+        the first output, which lets callers make their overall latency whole.
+    */
+    void reset (double initialPosition = 0.0);
+
+    /**
+        Appends numInputSamples and writes every output that can now be computed,
+        up to maxOutputSamples. Returns the number of samples written per channel.
+    */
+    int process (const float* const* input, int numInputSamples, float* const* output, int maxOutputSamples) noexcept;
+
+    //==============================================================================
+    /** Source samples consumed per output sample. */
+    double getStep() const noexcept                     { return step; }
+
+    /** An upper bound on the outputs produced by one process() call. */
+    int getMaxOutputSamples (int numInputSamples) const noexcept
+    {
+        return (int) std::ceil (numInputSamples / step) + 1;
+    }
+
+    /**
+        Output sample n represents source time n * step + initialPosition + getCentreOffset().
+        Callers combine this with their own buffering to compute latency.
+    */
+    static constexpr double getCentreOffset() noexcept  { return numTaps / 2 - 1; }
+
+private:
+    //==============================================================================
+    using Table = std::vector<float>;
+
+    static std::shared_ptr<const Table> getTable (float cutoff);
+    static std::shared_ptr<const Table> createTable (float cutoff);
+
+    std::shared_ptr<const Table> table;
+    juce::AudioBuffer<float> history;
+    int numBuffered = 0;
+    double position = 0.0;
+    double step = 1.0;
+};
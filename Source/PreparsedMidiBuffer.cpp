@@ -0,0 +1,300 @@
+#include "PreparsedMidiBuffer.h"
+
+namespace
+{
+    constexpr int rpnPitchBendRange = 0;
+    constexpr int rpnMpeConfiguration = 6;
+    constexpr float defaultBendRange = 2.0f;
+
+    /**
+        Parameter selection and data entry, which MidiRPNDetector assembles.
+        Data increment and decrement (96 and 97) aren't among them, so they
+        pass through as ordinary controllers.
+    */
+    bool isRpnController (int number) noexcept
+    {
+        return number == 6 || number == 38 || (number >= 98 && number <= 101);
+    }
+}
+
+//==============================================================================
+PreparsedMidiBuffer::PreparsedMidiBuffer (int capacityToUse)
+    : capacity (juce::jmax (1, capacityToUse))
+{
+    events.allocate ((size_t) capacity, true);
+    reset();
+}
+
+void PreparsedMidiBuffer::reset() noexcept
+{
+    numEvents = 0;
+    numDropped = 0;
+    rpnDetector.reset();
+    zoneLayout.clearAllZones();
+
+    for (auto& channel : controllerMsb)
+        std::fill (std::begin (channel), std::end (channel), (juce::uint8) 0);
+
+    for (auto& channel : controllerHasLsb)
+        std::fill (std::begin (channel), std::end (channel), false);
+
+    std::fill (std::begin (bendRange), std::end (bendRange), defaultBendRange);
+}
+
+juce::uint32 PreparsedMidiBuffer::scaleUp (juce::uint32 value, int srcBits, int dstBits) noexcept
+{
+    // MIDI 2.0 min-centre-max upscaling: the lower half is a plain shift, the
+    // upper half repeats the source bits so the maximum maps to the maximum
+    const auto scaleBits = dstBits - srcBits;
+    auto shifted = (juce::uint32) ((juce::uint64) value << scaleBits);
+
+    if (value <= (1u << (srcBits - 1)))
+        return shifted;
+
+    const auto repeatBits = srcBits - 1;
+    auto repeat = value & ((1u << repeatBits) - 1);
+    repeat = scaleBits > repeatBits ? repeat << (scaleBits - repeatBits)
+                                    : repeat >> (repeatBits - scaleBits);
+
+    while (repeat != 0)
+    {
+        shifted |= repeat;
+        repeat >>= repeatBits;
+    }
+
+    return shifted;
+}
+
+//==============================================================================
+void PreparsedMidiBuffer::parse (const juce::MidiBuffer& midi, int numSamples) noexcept
+{
+    numEvents = 0;
+    const auto lastSample = juce::jmax (0, numSamples - 1);
+
+    // MidiBuffer is ordered by time, so appending keeps the array sorted
+    for (const auto metadata : midi)
+    {
+        const auto* data = metadata.data;
+
+        if (metadata.numBytes < 1 || data[0] < 0x80 || data[0] >= 0xf0)
+            continue;
+
+        const auto offset = juce::jlimit (0, lastSample, metadata.samplePosition);
+        const auto status = data[0] & 0xf0;
+        const auto channel = (data[0] & 0x0f) + 1;
+        const int data1 = metadata.numBytes > 1 ? data[1] & 0x7f : 0;
+        const int data2 = metadata.numBytes > 2 ? data[2] & 0x7f : 0;
+
+        switch (status)
+        {
+            case 0x90:
+                if (data2 > 0)
+                {
+                    if (auto* e = add (offset, Event::Type::noteOn, channel))
+                    {
+                        e->note = (juce::uint8) data1;
+                        e->value = scaleUp ((juce::uint32) data2, 7, 16);
+                        e->normalised = (float) data2 / 127.0f;
+                    }
+
+                    break;
+                }
+
+                [[fallthrough]];
+
+            case 0x80:
+                if (auto* e = add (offset, Event::Type::noteOff, channel))
+                {
+                    // A note-on with velocity 0 is a note-off at the default velocity
+                    const auto velocity = status == 0x80 ? data2 : 64;
+                    e->note = (juce::uint8) data1;
+                    e->value = scaleUp ((juce::uint32) velocity, 7, 16);
+                    e->normalised = (float) velocity / 127.0f;
+                }
+                break;
+
+            case 0xa0:
+                if (auto* e = add (offset, Event::Type::polyPressure, channel))
+                {
+                    e->note = (juce::uint8) data1;
+                    e->value = scaleUp ((juce::uint32) data2, 7, 32);
+                    e->normalised = (float) data2 / 127.0f;
+                }
+                break;
+
+            case 0xb0:
+                handleController (offset, channel, data1, data2);
+                break;
+
+            case 0xc0:
+                if (auto* e = add (offset, Event::Type::programChange, channel))
+                {
+                    e->number = (juce::uint16) data1;
+                    e->value = (juce::uint32) data1;
+                    e->normalised = (float) data1 / 127.0f;
+                }
+                break;
+
+            case 0xd0:
+                if (auto* e = add (offset, Event::Type::channelPressure, channel))
+                {
+                    e->value = scaleUp ((juce::uint32) data1, 7, 32);
+                    e->normalised = (float) data1 / 127.0f;
+                }
+                break;
+
+            case 0xe0:
+                if (auto* e = add (offset, Event::Type::pitchBend, channel))
+                {
+                    const auto bend = data1 | (data2 << 7);
+                    e->value = scaleUp ((juce::uint32) bend, 14, 32);
+                    e->normalised = bend >= 8192 ? (float) (bend - 8192) / 8191.0f
+                                                 : (float) (bend - 8192) / 8192.0f;
+                    e->semitones = e->normalised * bendRange[channel - 1];
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+const PreparsedMidiBuffer::Event* PreparsedMidiBuffer::lowerBound (int sampleOffset) const noexcept
+{
+    return std::lower_bound (begin(), end(), sampleOffset,
+                             [] (const Event& e, int offset) { return e.sampleOffset < offset; });
+}
+
+//==============================================================================
+void PreparsedMidiBuffer::handleController (int offset, int channel, int number, int value) noexcept
+{
+    if (isRpnController (number))
+    {
+        // Selection and data entry only produce an event once a value is complete
+        if (const auto rpn = rpnDetector.tryParse (channel, number, value))
+            handleParameter (offset, *rpn);
+
+        return;
+    }
+
+    if (number == 120 || number == 123)
+    {
+        if (auto* e = add (offset, Event::Type::allNotesOff, channel))
+            e->number = (juce::uint16) number;
+
+        return;
+    }
+
+    if (number >= 120)
+        return;
+
+    auto* e = add (offset, Event::Type::controller, channel);
+
+    if (e == nullptr)
+        return;
+
+    auto& msb = controllerMsb[channel - 1];
+    auto& hasLsb = controllerHasLsb[channel - 1];
+
+    if (number < 32 && hasLsb[number])
+    {
+        // A new MSB resets its LSB
+        msb[number] = (juce::uint8) value;
+        e->number = (juce::uint16) number;
+        e->value = scaleUp ((juce::uint32) (value << 7), 14, 32);
+        e->normalised = (float) (value << 7) / 16383.0f;
+    }
+    else if (number < 32)
+    {
+        // Most senders never send the LSB, so until one arrives the MSB is a 7-bit value
+        msb[number] = (juce::uint8) value;
+        e->number = (juce::uint16) number;
+        e->value = scaleUp ((juce::uint32) value, 7, 32);
+        e->normalised = (float) value / 127.0f;
+    }
+    else if (number < 64)
+    {
+        hasLsb[number - 32] = true;
+        const auto full = (msb[number - 32] << 7) | value;
+        e->number = (juce::uint16) (number - 32);
+        e->value = scaleUp ((juce::uint32) full, 14, 32);
+        e->normalised = (float) full / 16383.0f;
+    }
+    else
+    {
+        e->number = (juce::uint16) number;
+        e->value = scaleUp ((juce::uint32) value, 7, 32);
+        e->normalised = (float) value / 127.0f;
+    }
+}
+
+void PreparsedMidiBuffer::handleParameter (int offset, const juce::MidiRPNMessage& rpn) noexcept
+{
+    const auto value14 = rpn.is14BitValue ? rpn.value : rpn.value << 7;
+    const auto channel = rpn.channel;
+
+    if (! rpn.isNRPN && rpn.parameterNumber == rpnMpeConfiguration && (channel == 1 || channel == 16))
+    {
+        const auto numMemberChannels = juce::jlimit (0, 15, value14 >> 7);
+
+        if (channel == 1)
+            zoneLayout.setLowerZone (numMemberChannels);
+        else
+            zoneLayout.setUpperZone (numMemberChannels);
+
+        // MPE defaults: 48 semitones on member channels, 2 on the master
+        for (int ch = 1; ch <= 16; ++ch)
+            bendRange[ch - 1] = isMemberChannel (ch) ? 48.0f : defaultBendRange;
+    }
+    else if (! rpn.isNRPN && rpn.parameterNumber == rpnPitchBendRange)
+    {
+        const auto range = (float) (value14 >> 7) + (float) (value14 & 0x7f) / 100.0f;
+
+        // In MPE a range sent on any member channel applies to every member channel of its zone
+        if (isMemberChannel (channel))
+        {
+            const auto zone = zoneLayout.getLowerZone().isUsingChannelAsMemberChannel (channel) ? zoneLayout.getLowerZone()
+                                                                                               : zoneLayout.getUpperZone();
+
+            for (int ch = 1; ch <= 16; ++ch)
+                if (zone.isUsingChannelAsMemberChannel (ch))
+                    bendRange[ch - 1] = range;
+        }
+        else
+        {
+            bendRange[channel - 1] = range;
+        }
+    }
+
+    if (auto* e = add (offset, Event::Type::parameter, channel))
+    {
+        e->number = (juce::uint16) rpn.parameterNumber;
+        e->isNrpn = rpn.isNRPN;
+        e->value = scaleUp ((juce::uint32) value14, 14, 32);
+        e->normalised = (float) value14 / 16383.0f;
+    }
+}
+
+PreparsedMidiBuffer::Event* PreparsedMidiBuffer::add (int offset, Event::Type type, int channel) noexcept
+{
+    if (numEvents >= capacity)
+    {
+        ++numDropped;
+        return nullptr;
+    }
+
+    auto& e = events[numEvents++];
+    e = {};
+    e.sampleOffset = offset;
+    e.type = type;
+    e.channel = (juce::uint8) channel;
+    e.perNote = isMemberChannel (channel);
+    return &e;
+}
+
+bool PreparsedMidiBuffer::isMemberChannel (int channel) const noexcept
+{
+    return zoneLayout.getLowerZone().isUsingChannelAsMemberChannel (channel)
+        || zoneLayout.getUpperZone().isUsingChannelAsMemberChannel (channel);
+}
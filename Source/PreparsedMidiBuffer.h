@@ -0,0 +1,106 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+    A block's MIDI, decoded once into a fixed-capacity array of typed events.
+
+    juce::MidiBuffer stores packed, variable-length bytes that every consumer
+    has to walk and decode again. parse() does that once per block: running
+    status, note-on with velocity 0, 14-bit controller pairs, RPN/NRPN data
+    entry and MPE zone configuration are all resolved here, so voice,
+    modulation and arpeggiator code just read flat structs in sample order.
+
+    Values are carried twice: at MIDI 2.0 resolution (16-bit velocities,
+    32-bit controllers, pressure and pitch bend, upscaled with the MIDI 2.0
+    min-centre-max rule) and as a ready-to-use float. Events on an MPE member
+    channel are flagged as per-note, and pitch bends come with the channel's
+    current bend range already applied.
+
+    The parser is stateful across blocks (controller MSBs, RPN selection, bend
+    ranges and the MPE zone layout), so call reset() when the stream restarts.
+    Nothing allocates after construction; events beyond the capacity are
+    dropped and counted.
+*/
+class PreparsedMidiBuffer
+{
+public:
+    //==============================================================================
+    struct Event
+    {
+        enum class Type : juce::uint8
+        {
+            noteOn,
+            noteOff,
+            pitchBend,
+            channelPressure,
+            polyPressure,
+            controller,         /**< number is 0-119; 14-bit pairs arrive as the MSB's number. */
+            parameter,          /**< An RPN or NRPN; number is the parameter number. */
+            programChange,
+            allNotesOff         /**< All notes off or all sound off; number is 123 or 120. */
+        };
+
+        int sampleOffset = 0;
+        Type type = Type::noteOn;
+        juce::uint8 channel = 1;        /**< 1-16. */
+        juce::uint8 note = 0;           /**< Note events and poly pressure only. */
+        bool perNote = false;           /**< Sent on an MPE member channel, so it belongs to that channel's note. */
+        juce::uint16 number = 0;        /**< Controller, RPN/NRPN or program number. */
+        bool isNrpn = false;
+        juce::uint32 value = 0;         /**< 16 bits for velocities, 32 bits otherwise; pitch bend is centred on 0x80000000. */
+        float normalised = 0.0f;        /**< 0 to 1, or -1 to 1 for pitch bend. */
+        float semitones = 0.0f;         /**< Pitch bend only: normalised times the channel's bend range. */
+    };
+
+    static constexpr int defaultCapacity = 2048;
+
+    explicit PreparsedMidiBuffer (int capacity = defaultCapacity);
+
+    //==============================================================================
+    /** Restores the default controller, bend range and MPE state. */
+    void reset() noexcept;
+
+    /** Replaces the contents with the decoded events of one block. Events are clamped to [0, numSamples). */
+    void parse (const juce::MidiBuffer& midi, int numSamples) noexcept;
+
+    //==============================================================================
+    const Event* begin() const noexcept         { return events.get(); }
+    const Event* end() const noexcept           { return events.get() + numEvents; }
+    int size() const noexcept                   { return numEvents; }
+    bool isEmpty() const noexcept               { return numEvents == 0; }
+    const Event& operator[] (int index) const noexcept { return events[index]; }
+
+    /** The first event at or after sampleOffset, for walking the block in sub-blocks. */
+    const Event* lowerBound (int sampleOffset) const noexcept;
+
+    /** Events that didn't fit since the last reset(). */
+    int getNumDropped() const noexcept          { return numDropped; }
+
+    int getCapacity() const noexcept            { return capacity; }
+
+    const juce::MPEZoneLayout& getZoneLayout() const noexcept { return zoneLayout; }
+
+    /** Upscales a value from srcBits to dstBits the MIDI 2.0 way, so full scale maps to full scale. */
+    static juce::uint32 scaleUp (juce::uint32 value, int srcBits, int dstBits) noexcept;
+
+private:
+    //==============================================================================
+    void handleController (int sampleOffset, int channel, int number, int value) noexcept;
+    void handleParameter (int sampleOffset, const juce::MidiRPNMessage& rpn) noexcept;
+    Event* add (int sampleOffset, Event::Type type, int channel) noexcept;
+    bool isMemberChannel (int channel) const noexcept;
+
+    juce::HeapBlock<Event> events;
+    int capacity = 0;
+    int numEvents = 0;
+    int numDropped = 0;
+
+    juce::MidiRPNDetector rpnDetector;
+    juce::MPEZoneLayout zoneLayout;
+    juce::uint8 controllerMsb[16][32] {};    /**< Last MSB of each 14-bit controller pair, per channel. */
+    bool controllerHasLsb[16][32] {};        /**< Whether that pair has had an LSB, which makes it 14-bit. */
+    float bendRange[16] {};                  /**< Semitones, per channel. */
+
+    JUCE_DECLARE_NON_COPYABLE (PreparsedMidiBuffer)
+};
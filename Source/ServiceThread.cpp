@@ -0,0 +1,81 @@
+#include "ServiceThread.h"
+#include "ExecutionContext.h"
+
+//==============================================================================
+ServiceThread::ServiceThread (const juce::String& threadName, juce::Thread::Priority priority, int pollMilliseconds)
+    : juce::Thread (threadName), pollIntervalMilliseconds (pollMilliseconds)
+{
+    startThread (priority);
+}
+
+ServiceThread::~ServiceThread()
+{
+    // Every client should have removed itself by now
+    jassert (clients.isEmpty());
+    stopThread (2000);
+}
+
+//==============================================================================
+void ServiceThread::add (Client& client)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        clients.addIfNotAlreadyThere (&client);
+    }
+
+    notify();
+}
+
+void ServiceThread::remove (Client& client)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        clients.removeFirstMatchingValue (&client);
+    }
+
+    // Once it's off the list the thread can't pick it up again, so only a call already under way is left
+    while (servingClient.load() == &client)
+        servingFinished.wait (1);
+}
+
+//==============================================================================
+void ServiceThread::run()
+{
+    ExecutionContext::ThreadScope context (getThreadName(), ExecutionContext::Role::worker);
+
+    while (! threadShouldExit())
+    {
+        bool didWork = false;
+
+        {
+            const juce::ScopedLock sl (lock);
+            passClients = clients;
+        }
+
+        for (auto* client : passClients)
+        {
+            {
+                // Skips a client removed since the copy was taken
+                const juce::ScopedLock sl (lock);
+
+                if (! clients.contains (client))
+                    continue;
+
+                servingClient = client;
+            }
+
+            {
+                const ExecutionContext::ScopedCycle cycle (context);
+                didWork = client->serviceBackgroundWork() || didWork;
+            }
+
+            servingClient = nullptr;
+            servingFinished.signal();
+        }
+
+        if (passClients.isEmpty())
+            wait (-1);
+        else if (! didWork)
+            wait (pollIntervalMilliseconds);
+    }
+}
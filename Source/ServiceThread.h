@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    One thread that does a kind of background work for every plugin instance
+    in the process, in turn, instead of a thread per instance.
+
+    Clients add themselves while they have work to do and remove themselves
+    before they go. Each pass calls every client's serviceBackgroundWork()
+    inside an ExecutionContext::ScopedCycle, and sleeps for the poll interval
+    when none of them had anything to do; with no clients it sleeps until
+    one is added. The lock is only held to copy the client list and to mark
+    which client is being served, never across the work itself, so one
+    client's disk reads don't hold up add() or remove() for another.
+    remove() waits while the client it removes is being served, so once it
+    returns the client's state is its own again.
+
+    Each kind of work gets its own thread, priority and poll interval through
+    a default-constructible subclass, which the clients share through a
+    juce::SharedResourcePointer.
+*/
+class ServiceThread  : private juce::Thread
+{
+public:
+    //==============================================================================
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        /** The service thread: does some work, and returns true if there was any. */
+        virtual bool serviceBackgroundWork() = 0;
+    };
+
+    //==============================================================================
+    ServiceThread (const juce::String& threadName, juce::Thread::Priority priority, int pollMilliseconds);
+    ~ServiceThread() override;
+
+    /** Not for the audio thread: starts serving client on the next pass. */
+    void add (Client& client);
+
+    /** Not for the audio thread: stops serving client, waiting for a call into it that is under way. */
+    void remove (Client& client);
+
+private:
+    //==============================================================================
+    void run() override;
+
+    const int pollIntervalMilliseconds;
+    juce::CriticalSection lock;
+    juce::Array<Client*> clients;               /**< Under the lock. */
+    juce::Array<Client*> passClients;           /**< This pass's copy of clients. The service thread only. */
+    std::atomic<Client*> servingClient { nullptr }; /**< Set under the lock, so remove() can't miss it. */
+    juce::WaitableEvent servingFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ServiceThread)
+};
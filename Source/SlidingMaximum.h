@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+    The maximum of the last windowSize values pushed, at a fixed cost per
+    value however long the window is.
+
+    This is the van Herk / Gil-Werman algorithm. The stream is cut into
+    blocks of windowSize values. Any window then spans the tail of one block
+    and the head of the next, so its maximum is the larger of the previous
+    block's suffix maximum and the current block's running prefix maximum.
+    The suffix maxima are computed once per block, as each block completes.
+    That is three comparisons per value averaged over a block, whatever the
+    data, unlike a monotonic deque, whose cost depends on the input.
+*/
+class SlidingMaximum
+{
+public:
+    //==============================================================================
+    /** Allocates for a window of newSize values and resets. Not realtime safe. */
+    void setWindowSize (int newSize)
+    {
+        windowSize = juce::jmax (1, newSize);
+        values.assign ((size_t) windowSize, 0.0f);
+        suffix.assign ((size_t) windowSize, 0.0f);
+        reset();
+    }
+
+    int getWindowSize() const noexcept              { return windowSize; }
+
+    /** Forgets everything pushed, as if the window were full of initialValue. */
+    void reset (float initialValue = 0.0f) noexcept
+    {
+        std::fill (suffix.begin(), suffix.end(), initialValue);
+        prefix = initialValue;
+        position = 0;
+    }
+
+    //==============================================================================
+    /** Adds a value and returns the maximum of it and the windowSize - 1 values before it. */
+    float push (float value) noexcept
+    {
+        jassert (! values.empty());
+
+        values[(size_t) position] = value;
+        prefix = position == 0 ? value : juce::jmax (prefix, value);
+
+        if (++position < windowSize)
+            return juce::jmax (suffix[(size_t) position], prefix);
+
+        // The block is complete: its suffix maxima serve the next block's windows
+        suffix[(size_t) windowSize - 1] = values[(size_t) windowSize - 1];
+
+        for (int i = windowSize - 2; i >= 0; --i)
+            suffix[(size_t) i] = juce::jmax (values[(size_t) i], suffix[(size_t) i + 1]);
+
+        position = 0;
+        return prefix;
+    }
+
+private:
+    //==============================================================================
+    std::vector<float> values;      /**< The current block so far. */
+    std::vector<float> suffix;      /**< suffix[i] is the maximum of the previous block from i to its end. */
+    float prefix = 0.0f;            /**< The maximum of the current block so far. */
+    int windowSize = 0;
+    int position = 0;               /**< Where the next value goes in the current block. */
+};
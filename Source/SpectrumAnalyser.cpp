@@ -0,0 +1,348 @@
+#include "SpectrumAnalyser.h"
+
+namespace
+{
+    constexpr double ringSeconds = 0.5;                 /**< How far the analysis thread may fall behind before blocks drop. */
+    constexpr int pollMilliseconds = 10;                /**< How long the analysis thread sleeps when the ring is empty. */
+    constexpr double spectrumTimeConstantSeconds = 0.15;
+    constexpr float relativeGateLu = 10.0f;
+    constexpr float histogramStepLu = 0.1f;
+    constexpr int interleavedChunkSize = 256;
+
+    static_assert (BiquadCascade::lanes >= SpectrumAnalyser::maxChannels, "Every channel needs its own lane");
+
+    /** BS.1770 mean square to LUFS, with the standard's -0.691 dB offset for the K-weighting's 1 kHz gain. */
+    float toLufs (double meanSquare) noexcept
+    {
+        return meanSquare > 0.0 ? (float) (-0.691 + 10.0 * std::log10 (meanSquare))
+                                : -std::numeric_limits<float>::infinity();
+    }
+
+    double toMeanSquare (float lufs) noexcept
+    {
+        return std::pow (10.0, (lufs + 0.691) / 10.0);
+    }
+
+    //==============================================================================
+    // The BS.1770 K-weighting filters, derived for any rate from their
+    // analogue prototypes (the standard only tabulates 48 kHz)
+    BiquadCascade::Coefficients makeKWeightingShelf (double sampleRate) noexcept
+    {
+        constexpr double f0 = 1681.974450955533, gainDecibels = 3.999843853973347, q = 0.7071752369554196;
+
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gainDecibels / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        return { (float) ((vh + vb * k / q + k * k) / a0),
+                 (float) (2.0 * (k * k - vh) / a0),
+                 (float) ((vh - vb * k / q + k * k) / a0),
+                 (float) (2.0 * (k * k - 1.0) / a0),
+                 (float) ((1.0 - k / q + k * k) / a0) };
+    }
+
+    BiquadCascade::Coefficients makeKWeightingHighPass (double sampleRate) noexcept
+    {
+        constexpr double f0 = 38.13547087602444, q = 0.5003270373238773;
+
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        return { 1.0f, -2.0f, 1.0f,
+                 (float) (2.0 * (k * k - 1.0) / a0),
+                 (float) ((1.0 - k / q + k * k) / a0) };
+    }
+}
+
+//==============================================================================
+SpectrumAnalyser::AnalysisThread::AnalysisThread()
+    : ServiceThread ("Spectrum analyser", juce::Thread::Priority::low, pollMilliseconds)
+{
+}
+
+//==============================================================================
+SpectrumAnalyser::SpectrumAnalyser()
+    : plan (planCache->getPlan (fftOrder))
+{
+    prepare (sampleRate, maxChannels, 512);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    analysisThread->remove (*this);
+}
+
+//==============================================================================
+void SpectrumAnalyser::prepare (double newSampleRate, int newNumChannels, int maxBlockSize)
+{
+    analysisThread->remove (*this);
+
+    sampleRate = newSampleRate;
+    numChannels = juce::jlimit (1, maxChannels, newNumChannels);
+
+    // AbstractFifo keeps one slot free, so the ring is one longer than what it holds
+    const auto capacity = juce::jmax (4 * maxBlockSize, (int) (ringSeconds * sampleRate));
+    fifo.setTotalSize (capacity + 1);
+    ring.setSize (numChannels, capacity + 1);
+
+    history.assign ((size_t) fftSize, 0.0f);
+    fftData.assign ((size_t) (2 * fftSize), 0.0f);
+    spectrumSmoothing = (float) std::exp (-hopSize / (spectrumTimeConstantSeconds * sampleRate));
+
+    kWeighting.setCoefficients (0, makeKWeightingShelf (sampleRate));
+    kWeighting.setCoefficients (1, makeKWeightingHighPass (sampleRate));
+    kWeighting.setStageActive (0, true);
+    kWeighting.setStageActive (1, true);
+    interleaved.resize ((size_t) interleavedChunkSize);
+    samplesPerStep = juce::roundToInt (sampleRate * 0.1);
+
+    resetMeasurements();
+
+    if (! analyseInline)
+        analysisThread->add (*this);
+}
+
+//==============================================================================
+void SpectrumAnalyser::push (const juce::AudioBuffer<float>& block) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    const auto channelsInBlock = juce::jmin (numChannels, block.getNumChannels());
+
+    auto copyToRing = [&] (int ringStart, int blockStart, int num)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (ch < channelsInBlock)
+                ring.copyFrom (ch, ringStart, block, ch, blockStart, num);
+            else
+                ring.clear (ch, ringStart, num);
+        }
+    };
+
+    if (analyseInline)
+    {
+        // The ring is just scratch here
+        for (int start = 0; start < numSamples; start += ring.getNumSamples())
+        {
+            const auto num = juce::jmin (ring.getNumSamples(), numSamples - start);
+            copyToRing (0, start, num);
+            analyse (0, num);
+        }
+
+        publishResults();
+        return;
+    }
+
+    if (fifo.getFreeSpace() < numSamples)
+    {
+        numDroppedSamples.fetch_add ((juce::uint64) numSamples, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto scope = fifo.write (numSamples);
+    copyToRing (scope.startIndex1, 0, scope.blockSize1);
+    copyToRing (scope.startIndex2, scope.blockSize1, scope.blockSize2);
+}
+
+//==============================================================================
+bool SpectrumAnalyser::serviceBackgroundWork()
+{
+    const auto numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+        return false;
+
+    {
+        const auto scope = fifo.read (numReady);
+        analyse (scope.startIndex1, scope.blockSize1);
+        analyse (scope.startIndex2, scope.blockSize2);
+    }
+
+    publishResults();
+    return true;
+}
+
+void SpectrumAnalyser::analyse (int startIndex, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    if (integratedResetRequested.exchange (false))
+        std::fill (std::begin (blockHistogram), std::end (blockHistogram), 0u);
+
+    // The spectrum looks at the channels' mix
+    const auto mixGain = 1.0f / (float) numChannels;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto mix = 0.0f;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            mix += ring.getSample (ch, startIndex + i);
+
+        history[(size_t) historyPosition] = mix * mixGain;
+        historyPosition = (historyPosition + 1) & (fftSize - 1);
+
+        if (++samplesSinceFrame == hopSize)
+        {
+            samplesSinceFrame = 0;
+            analyseSpectrum();
+        }
+    }
+
+    // Loudness sums the K-weighted channels' energy, every channel weighted 1 as for L and R
+    constexpr auto lanes = BiquadCascade::lanes;
+    auto* samples = reinterpret_cast<float*> (interleaved.data());
+
+    for (int start = 0; start < numSamples; start += interleavedChunkSize)
+    {
+        const auto num = juce::jmin (interleavedChunkSize, numSamples - start);
+        juce::FloatVectorOperations::clear (samples, num * lanes);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* src = ring.getReadPointer (ch, startIndex + start);
+
+            for (int i = 0; i < num; ++i)
+                samples[i * lanes + ch] = src[i];
+        }
+
+        kWeighting.process (interleaved.data(), num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                stepSum += juce::square ((double) samples[i * lanes + ch]);
+
+            if (++stepPosition == samplesPerStep)
+            {
+                addLoudnessStep (stepSum / samplesPerStep);
+                stepSum = 0.0;
+                stepPosition = 0;
+            }
+        }
+    }
+}
+
+void SpectrumAnalyser::analyseSpectrum() noexcept
+{
+    // Oldest sample first, through the window; the second half is the transform's workspace
+    for (int i = 0; i < fftSize; ++i)
+        fftData[(size_t) i] = history[(size_t) ((historyPosition + i) & (fftSize - 1))] * plan.window[(size_t) i];
+
+    std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+    plan.fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+    // A full-scale sine centred on a bin reads 0 dB
+    const auto scale = 2.0f / plan.windowSum;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto decibels = juce::Decibels::gainToDecibels (fftData[(size_t) bin] * scale, minimumDecibels);
+        smoothedSpectrum[bin] = decibels + (smoothedSpectrum[bin] - decibels) * spectrumSmoothing;
+    }
+
+    resultsChanged = true;
+}
+
+void SpectrumAnalyser::addLoudnessStep (double meanSquare) noexcept
+{
+    stepMeanSquares[numSteps % shortTermSteps] = meanSquare;
+    ++numSteps;
+
+    auto averageOfLast = [this] (int count)
+    {
+        count = juce::jmin (count, numSteps);
+        auto sum = 0.0;
+
+        for (int k = 0; k < count; ++k)
+            sum += stepMeanSquares[(numSteps - 1 - k) % shortTermSteps];
+
+        return sum / count;
+    };
+
+    const auto momentary = toLufs (averageOfLast (momentarySteps));
+    momentaryLufs = juce::jmax (silenceLufs, momentary);
+    shortTermLufs = juce::jmax (silenceLufs, toLufs (averageOfLast (shortTermSteps)));
+    shortTermLoudness.store (shortTermLufs, std::memory_order_relaxed);
+
+    // Every momentary window is a gating block: 400 ms, overlapping by 75%
+    if (numSteps >= momentarySteps && momentary > silenceLufs)
+    {
+        const auto bin = juce::jlimit (0, numHistogramBins - 1, (int) ((momentary - silenceLufs) / histogramStepLu));
+        ++blockHistogram[bin];
+    }
+
+    resultsChanged = true;
+}
+
+float SpectrumAnalyser::getIntegratedLoudness() const noexcept
+{
+    // Each bin stands in for its blocks at its centre loudness, within 0.05 LU
+    auto gatedLoudness = [this] (float gate)
+    {
+        auto sum = 0.0;
+        juce::uint64 count = 0;
+
+        for (int bin = 0; bin < numHistogramBins; ++bin)
+        {
+            const auto lufs = silenceLufs + ((float) bin + 0.5f) * histogramStepLu;
+
+            if (blockHistogram[bin] > 0 && lufs >= gate)
+            {
+                sum += blockHistogram[bin] * toMeanSquare (lufs);
+                count += blockHistogram[bin];
+            }
+        }
+
+        return count > 0 ? toLufs (sum / (double) count) : silenceLufs;
+    };
+
+    const auto ungated = gatedLoudness (silenceLufs);
+
+    if (ungated <= silenceLufs)
+        return silenceLufs;
+
+    return gatedLoudness (ungated - relativeGateLu);
+}
+
+void SpectrumAnalyser::resetMeasurements() noexcept
+{
+    fifo.reset();
+
+    std::fill (history.begin(), history.end(), 0.0f);
+    historyPosition = 0;
+    samplesSinceFrame = 0;
+    std::fill (std::begin (smoothedSpectrum), std::end (smoothedSpectrum), minimumDecibels);
+
+    kWeighting.reset();
+    stepPosition = 0;
+    stepSum = 0.0;
+    std::fill (std::begin (stepMeanSquares), std::end (stepMeanSquares), 0.0);
+    numSteps = 0;
+    momentaryLufs = shortTermLufs = silenceLufs;
+    std::fill (std::begin (blockHistogram), std::end (blockHistogram), 0u);
+    integratedResetRequested.store (false);
+    shortTermLoudness.store (silenceLufs);
+
+    resultsChanged = true;
+    publishResults();
+}
+
+void SpectrumAnalyser::publishResults() noexcept
+{
+    if (! resultsChanged)
+        return;
+
+    resultsChanged = false;
+
+    auto& r = results.getWriteBuffer();
+    std::copy (std::begin (smoothedSpectrum), std::end (smoothedSpectrum), std::begin (r.spectrum));
+    r.momentaryLufs = momentaryLufs;
+    r.shortTermLufs = shortTermLufs;
+    r.integratedLufs = getIntegratedLoudness();
+    r.sampleRate = sampleRate;
+    r.sequence = nextSequence++;
+    results.publish();
+}
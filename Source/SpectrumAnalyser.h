@@ -0,0 +1,158 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include "FftPlanCache.h"
+#include "ServiceThread.h"
+#include "TripleBuffer.h"
+
+/**
+    A spectrum analyser and ITU-R BS.1770 loudness meter that costs the audio
+    thread one copy per block.
+
+    push() copies the block into a lock-free single-producer, single-consumer
+    ring and returns; if the ring is full the block is dropped and counted,
+    never waited for. An analysis thread, one ServiceThread shared by every
+    analyser in the process, drains the ring and runs:
+    - Hann-windowed FFTs of the channel mix every hopSize samples (75%
+      overlap), with plans from the process-wide FftPlanCache, averaged into
+      a smoothed spectrum;
+    - K-weighting and 100 ms mean squares, giving momentary (400 ms) and
+      short-term (3 s) loudness, and gated integrated loudness from a
+      histogram of 400 ms blocks, so memory stays fixed however long the
+      programme runs.
+
+    Results reach one reader thread, normally the message thread, through a
+    TripleBuffer.
+    The short-term loudness is also kept in an atomic for the audio thread,
+    which can use it for loudness normalisation.
+
+    For offline renders, setAnalyseInline() analyses inside push() instead,
+    so the results depend only on the audio and not on thread timing.
+*/
+class SpectrumAnalyser  : private ServiceThread::Client
+{
+public:
+    //==============================================================================
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr int maxChannels = 2;
+
+    /** The absolute gate, and what every reading shows before there is any audio. */
+    static constexpr float silenceLufs = -70.0f;
+
+    /** The floor of the spectrum, in dBFS. */
+    static constexpr float minimumDecibels = -120.0f;
+
+    struct Results
+    {
+        float spectrum[numBins] {};             /**< Smoothed sine amplitude per bin, in dBFS. */
+        float momentaryLufs = silenceLufs;
+        float shortTermLufs = silenceLufs;
+        float integratedLufs = silenceLufs;
+        double sampleRate = 0.0;                /**< Bin i is centred on i * sampleRate / fftSize. */
+        juce::uint32 sequence = 0;              /**< Increments with every published update. */
+    };
+
+    //==============================================================================
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    /**
+        Sizes the ring and resets every measurement, with the analysis thread
+        off this analyser. Only the first maxChannels channels are measured.
+        Call it while the audio thread is stopped.
+    */
+    void prepare (double sampleRate, int numChannels, int maxBlockSize);
+
+    /**
+        Offline renders only: analyse in push(), on the calling thread, so
+        that results follow the audio sample for sample. Takes effect on the
+        next prepare().
+    */
+    void setAnalyseInline (bool shouldAnalyseInline) noexcept     { analyseInline = shouldAnalyseInline; }
+
+    /** Message thread: restarts the integrated loudness, e.g. when the transport restarts. */
+    void resetIntegratedLoudness() noexcept         { integratedResetRequested.store (true); }
+
+    //==============================================================================
+    /** Audio thread: queues the block for analysis. */
+    void push (const juce::AudioBuffer<float>& block) noexcept;
+
+    /** Any thread: the latest short-term loudness in LUFS, or silenceLufs. */
+    float getShortTermLoudness() const noexcept     { return shortTermLoudness.load (std::memory_order_relaxed); }
+
+    /** Samples dropped because the analysis thread fell a whole ring behind. */
+    juce::uint64 getNumDroppedSamples() const noexcept  { return numDroppedSamples.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** The reader thread (the editor's message thread): true if newer results are waiting. */
+    bool hasNewResults() const noexcept             { return results.hasNewValue(); }
+
+    /** The reader thread (the editor's message thread): the latest results. Valid until the next call. */
+    const Results& getLatestResults() noexcept      { return results.read(); }
+
+private:
+    /** The process-wide analysis thread. */
+    struct AnalysisThread  : public ServiceThread
+    {
+        AnalysisThread();
+    };
+
+    //==============================================================================
+    /** Analysis thread: analyses whatever the ring holds. */
+    bool serviceBackgroundWork() override;
+
+    /** Analysis thread, or push() when inline: runs everything on numSamples ring frames. */
+    void analyse (int startIndex, int numSamples) noexcept;
+
+    void analyseSpectrum() noexcept;
+    void addLoudnessStep (double meanSquare) noexcept;
+    float getIntegratedLoudness() const noexcept;
+    void resetMeasurements() noexcept;
+    void publishResults() noexcept;
+
+    juce::SharedResourcePointer<FftPlanCache> planCache;
+    const FftPlanCache::Plan& plan;
+    juce::SharedResourcePointer<AnalysisThread> analysisThread;
+
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> ring;
+    int numChannels = 0;
+    double sampleRate = 44100.0;
+    bool analyseInline = false;
+
+    // Spectrum: analysis side only
+    std::vector<float> history;             /**< The last fftSize samples of the channel mix, circular. */
+    std::vector<float> fftData;
+    int historyPosition = 0;
+    int samplesSinceFrame = 0;
+    float spectrumSmoothing = 0.0f;         /**< Per-frame weight of the previous spectrum. */
+    float smoothedSpectrum[numBins] {};
+
+    // Loudness: analysis side only
+    static constexpr int shortTermSteps = 30;
+    static constexpr int momentarySteps = 4;
+    static constexpr int numHistogramBins = 1000;
+
+    BiquadCascade kWeighting;
+    std::vector<BiquadCascade::Vec> interleaved;
+    int samplesPerStep = 0;                 /**< 100 ms. */
+    int stepPosition = 0;
+    double stepSum = 0.0;
+    double stepMeanSquares[shortTermSteps] {};
+    int numSteps = 0;
+    float momentaryLufs = silenceLufs, shortTermLufs = silenceLufs;
+    juce::uint32 blockHistogram[numHistogramBins] {};   /**< 400 ms block loudness above the absolute gate, in 0.1 LU bins. */
+    bool resultsChanged = false;            /**< Something to publish since the last publishResults(). */
+
+    TripleBuffer<Results> results;
+    juce::uint32 nextSequence = 1;
+
+    std::atomic<float> shortTermLoudness { silenceLufs };
+    std::atomic<bool> integratedResetRequested { false };
+    std::atomic<juce::uint64> numDroppedSamples { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
@@ -0,0 +1,465 @@
+#include "StreamingSampler.h"
+
+namespace
+{
+    constexpr double diskLatencySeconds = 0.02;     /**< A slow read the rings should ride out. */
+    constexpr double releaseSeconds = 0.03;
+    constexpr double stealFadeSeconds = 0.003;
+    constexpr int ioPollMilliseconds = 2;           /**< How long the I/O thread sleeps when every ring is full. */
+    constexpr int maxDiskWaitMilliseconds = 5000;   /**< With setWaitForDisk(), before giving up on a frame. */
+}
+
+//==============================================================================
+StreamingSampler::IoThread::IoThread()
+    : ServiceThread ("Sample streamer", juce::Thread::Priority::high, ioPollMilliseconds)
+{
+}
+
+//==============================================================================
+StreamingSampler::StreamingSampler (AssetLoader& l, AssetSlot<AudioAsset>& slot)
+    : loader (l), preloadSlot (slot)
+{
+    formatManager.registerBasicFormats();
+    prepare (sampleRate, 512);
+}
+
+StreamingSampler::~StreamingSampler()
+{
+    ioThread->remove (*this);
+    loader.remove (preloadSlot);
+}
+
+//==============================================================================
+void StreamingSampler::prepare (double newSampleRate, int maxBlockSize)
+{
+    ioThread->remove (*this);
+
+    sampleRate = newSampleRate;
+    const auto blockSize = juce::jmax (1, maxBlockSize);
+
+    // Output samples a ring has to cover: a few blocks of slack, the I/O
+    // thread topping up every other voice first, and one slow disk read...
+    const auto outputSamples = 4 * blockSize + maxVoices * blockSize / 4 + (int) (diskLatencySeconds * sampleRate);
+
+    // ...in source frames, for a sample at up to twice our rate played at the top of its range
+    const auto maxIncrement = 2.0 * std::pow (2.0, maxTransposition / 12.0);
+    readAheadSamples = juce::nextPowerOfTwo ((int) std::ceil (outputSamples * maxIncrement));
+    ioChunkSamples = readAheadSamples / 4;
+    releasePerSample = (float) (1.0 / (releaseSeconds * sampleRate));
+    stealFadePerSample = (float) (1.0 / (stealFadeSeconds * sampleRate));
+
+    // The I/O thread has let go of us and the audio thread isn't running, so the rings can be reset directly
+    for (auto& voice : voices)
+    {
+        voice.ring.setSize (maxChannels, readAheadSamples);
+        voice.ring.clear();
+        voice.streamReady.store (0);
+        voice.written.store (0);
+        voice.consumed.store (0);
+        voice.servicedRequest = 0;
+    }
+
+    readBuffer.setSize (maxChannels, ioChunkSamples);
+    reset();
+
+    // Nothing to stream without a sample; setSample() adds us when one comes
+    if (currentFile != juce::File())
+        ioThread->add (*this);
+
+    if (const auto newPreloadSamples = 2 * readAheadSamples; newPreloadSamples != preloadSamples)
+    {
+        preloadSamples = newPreloadSamples;
+
+        if (currentFile != juce::File())
+            setSample (currentFile, rootNote.load());
+    }
+}
+
+juce::uint32 StreamingSampler::setSample (const juce::File& file, int newRootNote)
+{
+    currentFile = file;
+    rootNote.store (newRootNote);
+
+    // The I/O thread only serves samplers that have something to stream
+    if (file == juce::File())
+        ioThread->remove (*this);
+    else
+        ioThread->add (*this);
+
+    const auto generation = loader.load (preloadSlot, { file, 0.0, 1, preloadSamples });
+
+    if (generation != 0)
+    {
+        const juce::ScopedLock sl (filesLock);
+        recentFiles[nextFileIndex] = { generation, file };
+        nextFileIndex = (nextFileIndex + 1) % juce::numElementsInArray (recentFiles);
+    }
+
+    return generation;
+}
+
+//==============================================================================
+void StreamingSampler::handleEvent (const PreparsedMidiBuffer::Event& event) noexcept
+{
+    using Type = PreparsedMidiBuffer::Event::Type;
+
+    switch (event.type)
+    {
+        case Type::noteOn:
+        {
+            AssetSlot<AudioAsset>::ScopedRead asset (preloadSlot);
+
+            if (asset)
+                startVoice (event, *asset.get());
+
+            break;
+        }
+
+        case Type::noteOff:
+            for (auto& voice : voices)
+                if (voice.active && ! voice.released && voice.note == event.note && voice.channel == event.channel)
+                    voice.released = true;
+
+            break;
+
+        case Type::allNotesOff:
+            for (auto& voice : voices)
+                if (voice.channel == event.channel)
+                    voice.released = true;
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+void StreamingSampler::render (juce::AudioBuffer<float>& block, int startSample, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    AssetSlot<AudioAsset>::ScopedRead asset (preloadSlot);
+
+    for (auto& voice : voices)
+    {
+        if (! voice.active)
+            continue;
+
+        // A new sample replaced the one this voice was reading
+        if (! asset || asset->generation != voice.sampleGeneration)
+            stopVoice (voice);
+        else
+            renderVoice (voice, *asset.get(), block, startSample, numSamples);
+    }
+}
+
+void StreamingSampler::reset() noexcept
+{
+    for (auto& voice : voices)
+        stopVoice (voice);
+}
+
+int StreamingSampler::getNumActiveVoices() const noexcept
+{
+    return (int) std::count_if (std::begin (voices), std::end (voices), [] (const Voice& v) { return v.active; });
+}
+
+//==============================================================================
+void StreamingSampler::startVoice (const PreparsedMidiBuffer::Event& event, const AudioAsset& asset) noexcept
+{
+    // A free voice, or else the oldest
+    auto* voice = &voices[0];
+
+    for (auto& v : voices)
+    {
+        if (! v.active)
+        {
+            voice = &v;
+            break;
+        }
+
+        if (v.startOrder < voice->startOrder)
+            voice = &v;
+    }
+
+    voice->released = false;
+    voice->note = event.note;
+    voice->channel = event.channel;
+    voice->velocity = event.normalised;
+    voice->startOrder = nextStartOrder++;
+
+    // A stolen voice fades out first and renderVoice() restarts it on the new note
+    if (voice->active)
+        voice->stolen = true;
+    else
+        restartVoice (*voice, asset);
+}
+
+void StreamingSampler::restartVoice (Voice& voice, const AudioAsset& asset) noexcept
+{
+    stopVoice (voice);
+
+    const auto transposition = juce::jmin (maxTransposition, voice.note - rootNote.load (std::memory_order_relaxed));
+
+    voice.active = true;
+    voice.position = 0.0;
+    voice.increment = asset.sampleRate / sampleRate * std::pow (2.0, transposition / 12.0);
+    voice.level = voice.velocity;
+    voice.envelope = 1.0f;
+    voice.sampleGeneration = asset.generation;
+    voice.preloadLength = asset.audio.getNumSamples();
+    voice.fileLength = asset.fileLengthInSamples;
+
+    // Short samples are resident in full and never stream
+    if (voice.preloadLength < voice.fileLength)
+    {
+        if (++nextRequest == 0)
+            ++nextRequest;
+
+        voice.request = nextRequest;
+        voice.streamGeneration.store (asset.generation, std::memory_order_relaxed);
+        voice.streamStart.store (voice.preloadLength, std::memory_order_relaxed);
+        voice.streamRequest.store (voice.request, std::memory_order_release);
+    }
+}
+
+void StreamingSampler::stopVoice (Voice& voice) noexcept
+{
+    voice.active = false;
+    voice.stolen = false;
+
+    if (voice.request != 0)
+    {
+        voice.request = 0;
+        voice.streamRequest.store (0, std::memory_order_release);
+    }
+}
+
+void StreamingSampler::renderVoice (Voice& voice, const AudioAsset& asset, juce::AudioBuffer<float>& block,
+                                    int startSample, int numSamples) noexcept
+{
+    const auto numOutputs = juce::jmin (maxChannels, block.getNumChannels());
+    const auto lastSourceChannel = asset.audio.getNumChannels() - 1;
+
+    // Only frames [consumed, written) of the ring are ours to read, and only once it holds our request
+    bool streaming = false;
+    juce::int64 written = 0, consumed = 0;
+
+    auto refreshStream = [&] () noexcept
+    {
+        streaming = voice.request != 0 && voice.streamReady.load (std::memory_order_acquire) == voice.request;
+        written = streaming ? voice.written.load (std::memory_order_acquire) : (juce::int64) 0;
+        consumed = streaming ? voice.consumed.load (std::memory_order_relaxed) : (juce::int64) 0;
+    };
+
+    refreshStream();
+    const auto ringMask = (juce::int64) voice.ring.getNumSamples() - 1;
+
+    auto getFrame = [&] (juce::int64 index, float* frame) noexcept
+    {
+        if (index < voice.preloadLength)
+        {
+            for (int ch = 0; ch < maxChannels; ++ch)
+                frame[ch] = asset.audio.getSample (juce::jmin (ch, lastSourceChannel), (int) index);
+
+            return true;
+        }
+
+        if (index >= voice.fileLength)
+        {
+            std::fill (frame, frame + maxChannels, 0.0f);
+            return true;
+        }
+
+        const auto ringIndex = index - voice.preloadLength;
+
+        if (ringIndex < consumed || ringIndex >= written)
+            return false;
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+            frame[ch] = voice.ring.getSample (ch, (int) (ringIndex & ringMask));
+
+        return true;
+    };
+
+    float* outputs[maxChannels] {};
+
+    for (int ch = 0; ch < numOutputs; ++ch)
+        outputs[ch] = block.getWritePointer (ch, startSample);
+
+    int starvedFrames = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto index = (juce::int64) voice.position;
+        const auto fraction = (float) (voice.position - (double) index);
+        float a[maxChannels], b[maxChannels];
+        auto available = getFrame (index, a) && getFrame (index + 1, b);
+
+        // Offline: hand back what's been played and give the I/O thread time, rather than drop audio
+        for (int waited = 0; ! available && waitForDisk && waited < maxDiskWaitMilliseconds; ++waited)
+        {
+            if (streaming)
+                voice.consumed.store (juce::jlimit (consumed, written, index - voice.preloadLength), std::memory_order_release);
+
+            juce::Thread::sleep (1);
+            refreshStream();
+            available = getFrame (index, a) && getFrame (index + 1, b);
+        }
+
+        if (available)
+        {
+            const auto gain = voice.level * voice.envelope;
+
+            for (int ch = 0; ch < numOutputs; ++ch)
+                outputs[ch][i] += gain * (a[ch] + fraction * (b[ch] - a[ch]));
+        }
+        else
+        {
+            ++starvedFrames;
+        }
+
+        voice.position += voice.increment;
+
+        if (voice.stolen)
+            voice.envelope -= stealFadePerSample;
+        else if (voice.released)
+            voice.envelope -= releasePerSample;
+
+        if (voice.envelope <= 0.0f || voice.position >= (double) voice.fileLength)
+        {
+            if (! voice.stolen)
+            {
+                stopVoice (voice);
+                break;
+            }
+
+            // The stolen note has faded out: the new one plays from the next frame
+            restartVoice (voice, asset);
+            refreshStream();
+        }
+    }
+
+    if (starvedFrames > 0)
+    {
+        numUnderruns.fetch_add (1, std::memory_order_relaxed);
+        numStarvedFrames.fetch_add ((juce::uint64) starvedFrames, std::memory_order_relaxed);
+    }
+
+    // Hand back the frames behind the play position so the I/O thread can refill them
+    if (streaming && voice.active)
+    {
+        const auto stillNeeded = (juce::int64) voice.position - voice.preloadLength;
+        voice.consumed.store (juce::jlimit (consumed, written, stillNeeded), std::memory_order_release);
+    }
+}
+
+//==============================================================================
+bool StreamingSampler::serviceBackgroundWork()
+{
+    bool didWork = false;
+
+    for (auto& voice : voices)
+        didWork = serviceVoice (voice) || didWork;
+
+    return didWork;
+}
+
+bool StreamingSampler::serviceVoice (Voice& voice)
+{
+    const auto request = voice.streamRequest.load (std::memory_order_acquire);
+
+    if (request == 0)
+        return false;
+
+    const auto generation = voice.streamGeneration.load (std::memory_order_relaxed);
+    const auto start = voice.streamStart.load (std::memory_order_relaxed);
+
+    // If the audio thread restarted the voice while we read the details, they may be mixed up
+    std::atomic_thread_fence (std::memory_order_acquire);
+
+    if (voice.streamRequest.load (std::memory_order_relaxed) != request)
+        return false;
+
+    if (request != voice.servicedRequest)
+    {
+        // The audio thread leaves the ring alone until streamReady matches its request
+        voice.written.store (0, std::memory_order_relaxed);
+        voice.consumed.store (0, std::memory_order_relaxed);
+        voice.servicedRequest = request;
+        voice.streamReady.store (request, std::memory_order_release);
+    }
+
+    if (! openReader (generation))
+        return false;
+
+    const auto ringSize = voice.ring.getNumSamples();
+    const auto written = voice.written.load (std::memory_order_relaxed);
+    const auto space = ringSize - (written - voice.consumed.load (std::memory_order_acquire));
+    const auto remaining = reader->lengthInSamples - (start + written);
+    const auto num = (int) juce::jmin (space, remaining, (juce::int64) ioChunkSamples);
+
+    // Wait for room for a whole chunk, unless that's all the file has left
+    if (num <= 0 || (num < ioChunkSamples && num < remaining))
+        return false;
+
+    const auto numReaderChannels = juce::jmin (maxChannels, (int) reader->numChannels);
+
+    if (! reader->read (readBuffer.getArrayOfWritePointers(), numReaderChannels, start + written, num))
+        return false;
+
+    for (int ch = numReaderChannels; ch < maxChannels; ++ch)
+        readBuffer.copyFrom (ch, 0, readBuffer, 0, 0, num);
+
+    // Written in at most two pieces around the end of the ring
+    const auto ringStart = (int) (written & (ringSize - 1));
+    const auto firstPart = juce::jmin (num, ringSize - ringStart);
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        juce::FloatVectorOperations::copy (voice.ring.getWritePointer (ch, ringStart), readBuffer.getReadPointer (ch), firstPart);
+
+        if (num > firstPart)
+            juce::FloatVectorOperations::copy (voice.ring.getWritePointer (ch), readBuffer.getReadPointer (ch, firstPart), num - firstPart);
+    }
+
+    voice.written.store (written + num, std::memory_order_release);
+    return true;
+}
+
+bool StreamingSampler::openReader (juce::uint32 generation)
+{
+    if (generation == readerGeneration && reader != nullptr)
+        return true;
+
+    if (generation == failedGeneration)
+        return false;
+
+    juce::File file;
+
+    {
+        const juce::ScopedLock sl (filesLock);
+
+        for (const auto& entry : recentFiles)
+            if (entry.generation == generation)
+                file = entry.file;
+    }
+
+    // setSample() hasn't recorded it yet; try again on the next pass
+    if (file == juce::File())
+        return false;
+
+    // An ordinary buffered reader rather than a mapped one, so a multi-GB
+    // library doesn't take address space in proportion to its size
+    reader.reset (formatManager.createReaderFor (file));
+    readerGeneration = generation;
+
+    if (reader == nullptr)
+    {
+        failedGeneration = generation;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "AssetLoader.h"
+#include "PreparsedMidiBuffer.h"
+#include "ServiceThread.h"
+
+/**
+    A sampler whose memory use doesn't depend on the size of its samples.
+
+    Only the attack of the sample stays resident: AssetLoader reads the first
+    getPreloadSamples() frames into an AssetSlot. When a voice plays past
+    them, it reads from its own single-producer, single-consumer ring buffer,
+    which an I/O thread keeps topped up from the file; every sampler in the
+    process shares that one ServiceThread. The audio thread never opens,
+    reads or waits on a file. If the disk falls behind, the voice plays
+    silence for the missing frames, keeps its place and picks up where the
+    ring catches up; every such block is counted in getNumUnderruns(). A
+    sampler is only on the I/O thread's list while it has a sample loaded.
+
+    RAM is the preload plus maxVoices rings of getReadAheadSamples() frames,
+    whatever the file's length. Both are sized in prepare() from the block
+    size and the voice count: each ring holds enough to ride out a few
+    blocks, the I/O thread working through every other voice first, and a
+    slow disk read. The preload is twice that, so a new voice is primed long
+    before it leaves the resident part.
+
+    Notes play the sample at its own rate on rootNote, repitched by linear
+    interpolation up to maxTransposition semitones above it. A stolen voice
+    fades out over a few milliseconds before it restarts on the new note.
+*/
+class StreamingSampler  : private ServiceThread::Client
+{
+public:
+    //==============================================================================
+    static constexpr int maxVoices = 16;
+    static constexpr int maxChannels = 2;
+    static constexpr int maxTransposition = 12;
+
+    /**
+        The loader reads the preloads into slot. Both must outlive the sampler,
+        which takes the slot back from the loader when it goes.
+    */
+    StreamingSampler (AssetLoader& loader, AssetSlot<AudioAsset>& slot);
+    ~StreamingSampler() override;
+
+    //==============================================================================
+    /**
+        Sizes the preload and the voice rings, with the I/O thread off them.
+        Reloads the current sample if the preload length changed. Call it
+        while the audio thread is stopped.
+    */
+    void prepare (double sampleRate, int maxBlockSize);
+
+    /**
+        Message thread: loads the attack of file in the background and streams
+        the rest on demand. An empty File unloads the sample. Returns the
+        preload's generation, for AssetLoader::waitUntilLoaded(), or 0.
+    */
+    juce::uint32 setSample (const juce::File& file, int rootNote = 60);
+
+    //==============================================================================
+    /** Audio thread: starts and stops notes. Other events are ignored. */
+    void handleEvent (const PreparsedMidiBuffer::Event& event) noexcept;
+
+    /** Audio thread: adds numSamples of every active voice to the first two channels of block. */
+    void render (juce::AudioBuffer<float>& block, int startSample, int numSamples) noexcept;
+
+    /**
+        Offline renders only: when a voice reaches audio the I/O thread hasn't
+        read yet, block the calling thread until it has, instead of playing
+        silence. Output then no longer depends on disk timing. Set it while
+        the audio thread is stopped.
+    */
+    void setWaitForDisk (bool shouldWait) noexcept     { waitForDisk = shouldWait; }
+
+    /** Audio thread: silences every voice. */
+    void reset() noexcept;
+
+    //==============================================================================
+    int getNumActiveVoices() const noexcept;
+
+    /** Voice blocks that reached a frame the I/O thread hadn't read yet. */
+    juce::uint32 getNumUnderruns() const noexcept      { return numUnderruns.load (std::memory_order_relaxed); }
+
+    /** The total number of frames played as silence because of underruns. */
+    juce::uint64 getNumStarvedFrames() const noexcept  { return numStarvedFrames.load (std::memory_order_relaxed); }
+
+    /** Frames of each sample kept in memory. */
+    int getPreloadSamples() const noexcept             { return preloadSamples; }
+
+    /** Frames each voice's ring buffer holds ahead of its play position. */
+    int getReadAheadSamples() const noexcept           { return readAheadSamples; }
+
+private:
+    //==============================================================================
+    struct Voice
+    {
+        // Audio thread only
+        bool active = false;
+        bool released = false;
+        bool stolen = false;                /**< Fading out; note, channel and velocity are already the next note's. */
+        int note = 0;
+        int channel = 1;
+        double position = 0.0;              /**< The next source frame to play, with its fraction. */
+        double increment = 1.0;
+        float velocity = 0.0f;
+        float level = 0.0f;                 /**< The playing note's velocity. */
+        float envelope = 1.0f;
+        juce::uint32 startOrder = 0;
+        juce::uint32 sampleGeneration = 0;  /**< The preload the voice was started on. */
+        juce::int64 preloadLength = 0;
+        juce::int64 fileLength = 0;
+        juce::uint32 request = 0;           /**< This voice's current stream, or 0 if it plays from the preload alone. */
+
+        // Audio thread to I/O thread: what to stream. The details are written before the request.
+        std::atomic<juce::uint32> streamRequest { 0 };
+        std::atomic<juce::uint32> streamGeneration { 0 };
+        std::atomic<juce::int64> streamStart { 0 };
+
+        // I/O thread to audio thread: the ring holds streamReady's frames [consumed, written)
+        std::atomic<juce::uint32> streamReady { 0 };
+        std::atomic<juce::int64> written { 0 };
+        std::atomic<juce::int64> consumed { 0 };
+        juce::uint32 servicedRequest = 0;   /**< I/O thread only. */
+
+        juce::AudioBuffer<float> ring;
+    };
+
+    /** The process-wide I/O thread. */
+    struct IoThread  : public ServiceThread
+    {
+        IoThread();
+    };
+
+    //==============================================================================
+    /** I/O thread: services every voice. */
+    bool serviceBackgroundWork() override;
+
+    /** I/O thread: restarts or tops up one voice's ring. Returns true if it read anything. */
+    bool serviceVoice (Voice& voice);
+
+    /** I/O thread: makes sure reader is open on the file that produced generation. */
+    bool openReader (juce::uint32 generation);
+
+    void startVoice (const PreparsedMidiBuffer::Event& event, const AudioAsset& asset) noexcept;
+    void stopVoice (Voice& voice) noexcept;
+
+    /** Plays voice's note from the start of asset. */
+    void restartVoice (Voice& voice, const AudioAsset& asset) noexcept;
+
+    void renderVoice (Voice& voice, const AudioAsset& asset, juce::AudioBuffer<float>& block,
+                      int startSample, int numSamples) noexcept;
+
+    AssetLoader& loader;
+    AssetSlot<AudioAsset>& preloadSlot;
+    juce::AudioFormatManager formatManager;
+    juce::SharedResourcePointer<IoThread> ioThread;
+
+    Voice voices[maxVoices];
+    double sampleRate = 44100.0;
+    int preloadSamples = 0;
+    int readAheadSamples = 0;
+    int ioChunkSamples = 0;             /**< The most the I/O thread reads for one voice at a time. */
+    float releasePerSample = 0.0f;
+    float stealFadePerSample = 0.0f;
+    bool waitForDisk = false;
+    std::atomic<int> rootNote { 60 };
+    juce::uint32 nextStartOrder = 0;
+    juce::uint32 nextRequest = 0;
+
+    // The files behind recent preload generations, so the I/O thread can open the right one
+    struct SampleFile
+    {
+        juce::uint32 generation = 0;
+        juce::File file;
+    };
+
+    juce::CriticalSection filesLock;    /**< The message and I/O threads only. */
+    SampleFile recentFiles[4];
+    int nextFileIndex = 0;
+    juce::File currentFile;             /**< Message thread only. */
+
+    // I/O thread only
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::uint32 readerGeneration = 0;
+    juce::uint32 failedGeneration = 0;
+    juce::AudioBuffer<float> readBuffer;
+
+    std::atomic<juce::uint32> numUnderruns { 0 };
+    std::atomic<juce::uint64> numStarvedFrames { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamingSampler)
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+/**
+    Hands the latest copy of a plain value (a spectrum, a set of meter
+    readings) from one writer thread to one reader thread without locks on
+    either side.
+
+    There are three copies: the writer fills its own, then publish() swaps it
+    with the spare one in a single atomic exchange. read() swaps the spare
+    into the reader's hands if something newer was published since the last
+    call. Neither side ever waits, and a slow reader just skips the updates
+    it missed. The value is copied by the writer, so keep it to a few KB.
+*/
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+    //==============================================================================
+    TripleBuffer() = default;
+
+    //==============================================================================
+    /** Writer: the copy to fill in before the next publish(). */
+    ValueType& getWriteBuffer() noexcept            { return buffers[writeIndex]; }
+
+    /** Writer: makes the write buffer the latest value and starts a new one. */
+    void publish() noexcept
+    {
+        writeIndex = spare.exchange (writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    //==============================================================================
+    /** Reader: true if something was published since the last read(). */
+    bool hasNewValue() const noexcept               { return (spare.load (std::memory_order_relaxed) & freshBit) != 0; }
+
+    /**
+        Reader: the most recently published value, or a default-constructed
+        one before the first publish(). The reference stays valid until the
+        next read().
+    */
+    const ValueType& read() noexcept
+    {
+        if (hasNewValue())
+            readIndex = spare.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+
+        return buffers[readIndex];
+    }
+
+private:
+    //==============================================================================
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;      /**< Set in spare when it holds a value the reader hasn't seen. */
+
+    ValueType buffers[3] {};
+    int writeIndex = 0;                     /**< Writer only. */
+    int readIndex = 1;                      /**< Reader only. */
+    std::atomic<int> spare { 2 };
+
+    JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
@@ -0,0 +1,160 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/AssetLoader.h"
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+
+/**
+ * Asset Loader Tests for VstTestPlayground
+ * Tests background loading, superseding requests and the RCU hand-off to the audio thread
+ */
+class AssetLoaderTests : public juce::UnitTest
+{
+public:
+    AssetLoaderTests() : juce::UnitTest("Asset Loader Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Slot Defers Reclaiming Until The Reader Lets Go");
+        {
+            AssetSlot<int> slot;
+            slot.publish(std::make_unique<int>(1));
+
+            const auto* held = slot.acquire();
+            expectEquals(*held, 1);
+
+            slot.publish(std::make_unique<int>(2));
+            expectEquals(slot.reclaim(), 1, "The object the reader holds must survive");
+            expectEquals(*held, 1);
+
+            slot.release();
+            expectEquals(slot.reclaim(), 0, "Released objects should be freed");
+
+            AssetSlot<int>::ScopedRead read(slot);
+            expect(read && *read.get() == 2);
+        }
+
+        beginTest("Loads A WAV In The Background");
+        {
+            juce::TemporaryFile temp(".wav");
+            const auto source = makeSine(1, 44100.0, 20000);
+            expect(TestHelpers::writeWav(temp.getFile(), source, 44100.0));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            loader.load(slot, { temp.getFile() });
+            expect(loader.waitUntilIdle(10000), "The load should finish");
+
+            AssetSlot<AudioAsset>::ScopedRead asset(slot);
+            expect(asset.get() != nullptr, "The asset should have been published");
+            expectEquals(asset->audio.getNumSamples(), 20000);
+            expectEquals(asset->sampleRate, 44100.0);
+
+            float maxError = 0.0f;
+            for (int i = 0; i < 20000; ++i)
+                maxError = juce::jmax(maxError, std::abs(asset->audio.getSample(0, i) - source.getSample(0, i)));
+
+            expect(maxError < 1.0e-6f, "Decoded audio should match what was written");
+        }
+
+        beginTest("Resamples To The Target Rate Without Shifting The Start");
+        {
+            juce::TemporaryFile temp(".wav");
+            expect(TestHelpers::writeWav(temp.getFile(), makeSine(2, 44100.0, 44100), 44100.0));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            loader.load(slot, { temp.getFile(), 48000.0 });
+            expect(loader.waitUntilIdle(10000));
+
+            AssetSlot<AudioAsset>::ScopedRead asset(slot);
+            expect(asset.get() != nullptr);
+            expectEquals(asset->sampleRate, 48000.0);
+            expectEquals(asset->audio.getNumSamples(), 48000);
+            expectEquals(asset->fileLengthInSamples, (juce::int64) 44100);
+
+            const auto expected = makeSine(1, 48000.0, 48000);
+            float maxError = 0.0f;
+            for (int i = 1000; i < 47000; ++i)
+                maxError = juce::jmax(maxError, std::abs(asset->audio.getSample(1, i) - expected.getSample(0, i)));
+
+            expect(maxError < 1.0e-4f, "Resampled sine should line up with the ideal one, max error " + juce::String(maxError));
+        }
+
+        beginTest("Newer Request Supersedes An Older One");
+        {
+            juce::TemporaryFile large(".wav"), small(".wav");
+            expect(TestHelpers::writeWav(large.getFile(), makeSine(2, 44100.0, 44100 * 20), 44100.0));
+            expect(TestHelpers::writeWav(small.getFile(), makeSine(1, 44100.0, 1000), 44100.0));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader(1);
+            loader.load(slot, { large.getFile(), 48000.0 });
+            loader.load(slot, { small.getFile() });
+            expect(loader.waitUntilIdle(30000));
+
+            AssetSlot<AudioAsset>::ScopedRead asset(slot);
+            expect(asset.get() != nullptr && asset->file == small.getFile(), "The newest request should win");
+            expectEquals(loader.getNumFailed(), 0, "A superseded load is not a failure");
+        }
+
+        beginTest("Waits For One Slot's Request Only");
+        {
+            juce::TemporaryFile large(".wav"), small(".wav");
+            expect(TestHelpers::writeWav(large.getFile(), makeSine(2, 44100.0, 44100 * 20), 44100.0));
+            expect(TestHelpers::writeWav(small.getFile(), makeSine(1, 44100.0, 1000), 44100.0));
+
+            AssetSlot<AudioAsset> busySlot, slot;
+            AssetLoader loader(2);
+            loader.load(busySlot, { large.getFile(), 48000.0 });
+            const auto generation = loader.load(slot, { small.getFile() });
+            expect(loader.waitUntilLoaded(slot, generation, 10000));
+
+            {
+                AssetSlot<AudioAsset>::ScopedRead asset(slot);
+                expect(asset.get() != nullptr && asset->generation == generation, "The awaited request should be published");
+            }
+
+            // A superseded request counts as finished
+            const auto superseded = loader.load(slot, { large.getFile() });
+            loader.load(slot, { small.getFile() });
+            expect(loader.waitUntilLoaded(slot, superseded, 10000));
+            expect(loader.waitUntilIdle(30000));
+        }
+
+        beginTest("Restoring State Queues The Sample Instead Of Loading It");
+        {
+            juce::TemporaryFile temp(".wav");
+            expect(TestHelpers::writeWav(temp.getFile(), makeSine(1, 44100.0, 44100 * 10), 44100.0));
+
+            juce::MemoryBlock state;
+            {
+                VstTestPlaygroundAudioProcessor processor;
+                processor.loadSample(temp.getFile());
+                processor.getStateInformation(state);
+            }
+
+            VstTestPlaygroundAudioProcessor restored;
+            restored.setStateInformation(state.getData(), (int) state.getSize());
+            expect(restored.getAssetLoader().waitUntilIdle(10000));
+
+            AssetSlot<AudioAsset>::ScopedRead asset(restored.getSampleSlot());
+            expect(asset.get() != nullptr && asset->file == temp.getFile(), "The saved sample should be reloaded");
+        }
+    }
+
+private:
+    static juce::AudioBuffer<float> makeSine(int numChannels, double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample(ch, i, 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * 441.0 * i / sampleRate));
+
+        return buffer;
+    }
+};
+
+// Register the test suite
+static AssetLoaderTests assetLoaderTests;
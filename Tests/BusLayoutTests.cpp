@@ -0,0 +1,143 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/ChannelKernels.h"
+#include "../Source/Params.h"
+
+/**
+ * Bus Layout Tests for VstTestPlayground
+ * Tests the accepted output/sidechain layouts and the channel-specialised kernels
+ */
+class BusLayoutTests : public juce::UnitTest
+{
+public:
+    BusLayoutTests() : juce::UnitTest("Bus Layout Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Supported Output Layouts");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+
+            for (const auto& set : { juce::AudioChannelSet::mono(),
+                                     juce::AudioChannelSet::stereo(),
+                                     juce::AudioChannelSet::create5point1(),
+                                     juce::AudioChannelSet::create7point1(),
+                                     juce::AudioChannelSet::create7point1point4() })
+            {
+                expect(processor.checkBusesLayoutSupported(makeLayout(processor, set)),
+                       "Layout should be supported: " + set.getDescription());
+            }
+        }
+
+        beginTest("Unsupported Output Layouts");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+
+            expect(! processor.checkBusesLayoutSupported(makeLayout(processor, juce::AudioChannelSet::disabled())),
+                   "Disabled output should be rejected");
+            expect(! processor.checkBusesLayoutSupported(makeLayout(processor, juce::AudioChannelSet::discreteChannels(16))),
+                   "Layouts wider than 7.1.4 should be rejected");
+        }
+
+        beginTest("Sidechain Layouts");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            auto layout = makeLayout(processor, juce::AudioChannelSet::stereo());
+
+            expect(VstTestPlaygroundAudioProcessor::sidechainBusIndex < layout.inputBuses.size(),
+                   "Processor should declare a sidechain input bus");
+
+            layout.inputBuses.getReference(VstTestPlaygroundAudioProcessor::sidechainBusIndex) = juce::AudioChannelSet::mono();
+            expect(processor.checkBusesLayoutSupported(layout), "Mono sidechain should be supported");
+
+            layout.inputBuses.getReference(VstTestPlaygroundAudioProcessor::sidechainBusIndex) = juce::AudioChannelSet::create5point1();
+            expect(! processor.checkBusesLayoutSupported(layout), "Surround sidechain should be rejected");
+        }
+
+        beginTest("Mono And Surround Processing");
+        {
+            for (const auto& set : { juce::AudioChannelSet::mono(), juce::AudioChannelSet::create7point1point4() })
+            {
+                VstTestPlaygroundAudioProcessor processor;
+                expect(processor.setBusesLayout(makeLayout(processor, set)), "Layout should be applied");
+
+                auto* gainParam = processor.apvts.getParameter(Params::GAIN_ID);
+                gainParam->setValueNotifyingHost(gainParam->convertTo0to1(-6.0f));
+                processor.prepareToPlay(44100.0, 256);
+
+                // Inputs and outputs share channels, as a host lays them out
+                juce::AudioBuffer<float> buffer(juce::jmax(processor.getTotalNumInputChannels(),
+                                                           processor.getTotalNumOutputChannels()), 256);
+                juce::MidiBuffer midiBuffer;
+
+                // A different level on every channel, so a dropped or swapped channel shows
+                auto levelFor = [&] (int ch) { return 0.05f * (float) (ch + 1); };
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), levelFor(ch), buffer.getNumSamples());
+
+                processor.processBlock(buffer, midiBuffer);
+
+               #if ! JucePlugin_IsSynth
+                const auto expectedGain = juce::Decibels::decibelsToGain(-6.0f);
+
+                for (int ch = 0; ch < processor.getMainBusNumOutputChannels(); ++ch)
+                    expectWithinAbsoluteError(buffer.getSample(ch, buffer.getNumSamples() - 1), levelFor(ch) * expectedGain, 1.0e-4f,
+                                              "Channel " + juce::String(ch) + " of " + set.getDescription() + " should get the gain");
+               #endif
+            }
+        }
+
+        beginTest("Specialised Kernels Match Generic Kernel");
+        {
+            constexpr int numSamples = 67;
+            juce::Random random(0x5eed);
+
+            juce::HeapBlock<float> ramp(numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                ramp[i] = random.nextFloat();
+
+            for (int numChannels = 1; numChannels <= 2; ++numChannels)
+            {
+                juce::AudioBuffer<float> specialised(numChannels, numSamples);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        specialised.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                juce::AudioBuffer<float> generic(specialised);
+
+                ChannelKernels::dispatch(numChannels, [&] (auto channelCount)
+                {
+                    constexpr int N = decltype (channelCount)::value;
+                    ChannelKernels::applyGainRamp<N>(specialised.getArrayOfWritePointers(), numChannels, ramp, numSamples);
+                });
+
+                ChannelKernels::applyGainRamp<ChannelKernels::dynamicChannelCount>(generic.getArrayOfWritePointers(),
+                                                                                   numChannels, ramp, numSamples);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        expectWithinAbsoluteError(specialised.getSample(ch, i), generic.getSample(ch, i), 1.0e-7f,
+                                                  "Specialised kernel should match the generic kernel");
+            }
+        }
+    }
+
+private:
+    static juce::AudioProcessor::BusesLayout makeLayout(const VstTestPlaygroundAudioProcessor& processor,
+                                                        const juce::AudioChannelSet& output)
+    {
+        auto layout = processor.getBusesLayout();
+        layout.getMainOutputChannelSet() = output;
+
+       #if ! JucePlugin_IsSynth
+        layout.getMainInputChannelSet() = output;
+       #endif
+
+        return layout;
+    }
+};
+
+// Register the test suite
+static BusLayoutTests busLayoutTests;
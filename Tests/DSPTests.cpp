@@ -0,0 +1,461 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/PolyphaseResampler.h"
+#include "../Source/InternalRateConverter.h"
+#include "../Source/FixedBlockAdapter.h"
+#include "../Source/ChannelKernels.h"
+#include "../Source/EqualiserStage.h"
+#include "../Source/MultibandCompressor.h"
+#include "../Source/SlidingMaximum.h"
+#include "../Source/LookaheadLimiter.h"
+#include "../Source/Params.h"
+
+/**
+ * DSP Tests for VstTestPlayground
+ * Tests the individual DSP building blocks in isolation
+ */
+class DSPTests : public juce::UnitTest
+{
+public:
+    DSPTests() : juce::UnitTest("DSP Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Internal Rate Converter Delays By Reported Latency");
+        {
+            for (auto hostRate : { 44100.0, 96000.0, 192000.0 })
+            {
+                InternalRateConverter converter;
+                converter.prepare(hostRate, 48000.0, 1, 256);
+                expect(converter.isActive(), "Converter should be active when rates differ");
+
+                const auto latency = converter.getLatencySamples();
+                const auto total = (int) hostRate / 2;
+
+                juce::AudioBuffer<float> signal(1, total);
+                for (int i = 0; i < total; ++i)
+                    signal.setSample(0, i, (float) std::sin(juce::MathConstants<double>::twoPi * 1000.0 * i / hostRate));
+
+                juce::AudioBuffer<float> output(signal);
+                juce::Random random(42);
+
+                // Irregular host blocks, including single samples and oversized blocks
+                for (int pos = 0; pos < total;)
+                {
+                    const auto num = juce::jmin(1 + random.nextInt(600), total - pos);
+                    juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 1, pos, num);
+                    converter.process(block, [] (juce::AudioBuffer<float>&) {});
+                    pos += num;
+                }
+
+                float maxError = 0.0f;
+                for (int i = latency + 2000; i < total; ++i)
+                    maxError = juce::jmax(maxError, std::abs(output.getSample(0, i) - signal.getSample(0, i - latency)));
+
+                expect(maxError < 1.0e-4f, "Round trip at " + juce::String(hostRate) + " Hz should match the input delayed by "
+                                           + juce::String(latency) + " samples, max error " + juce::String(maxError));
+            }
+        }
+
+        beginTest("Internal Rate Converter Bypasses Matching Rates");
+        {
+            InternalRateConverter converter;
+            converter.prepare(48000.0, 48000.0, 2, 512);
+            expect(! converter.isActive(), "Converter should be inactive at the internal rate");
+            expectEquals(converter.getLatencySamples(), 0, "Bypass should not add latency");
+        }
+
+        beginTest("Processor Reports Resampling Latency");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            processor.setInternalSampleRate(48000.0);
+            processor.prepareToPlay(192000.0, 512);
+            expect(processor.getLatencySamples() > 0, "Fixed-rate processing should report latency at 192 kHz");
+
+            processor.setInternalSampleRate(0.0);
+            processor.prepareToPlay(192000.0, 512);
+            expectEquals(processor.getLatencySamples(), quantumLatency + limiterLatency(192000.0),
+                         "Host-rate processing should report only the quantum FIFO's and the limiter's latency");
+        }
+
+        beginTest("Fixed Block Adapter FIFO Processes Whole Quanta");
+        {
+            FixedBlockAdapter<32, true> adapter;
+            adapter.prepare(2, 512);
+            expectEquals(adapter.getLatencySamples(), 32, "The FIFO should delay by one quantum");
+            expectEquals(adapter.getMaxProcessingBlockSize(), 32, "Every quantum should be exactly 32 samples");
+
+            const auto signal = createNoise(2, 20000);
+            auto expected = juce::AudioBuffer<float>(signal);
+            OnePole reference;
+            reference.process(expected);
+
+            OnePole stage;
+            int numWrongSizes = 0;
+            const auto output = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block)
+            {
+                adapter.process(block, [&] (juce::AudioBuffer<float>& quantum)
+                {
+                    numWrongSizes += quantum.getNumSamples() != 32 ? 1 : 0;
+                    stage.process(quantum);
+                });
+            });
+
+            expectEquals(numWrongSizes, 0, "The callback should only see whole quanta");
+            expect(isDelayedCopy(output, expected, 32), "Output should be the processed input delayed by 32 samples");
+        }
+
+        beginTest("Fixed Block Adapter Splits Blocks In Place");
+        {
+            FixedBlockAdapter<32, false> adapter;
+            adapter.prepare(2, 512);
+            expectEquals(adapter.getLatencySamples(), 0, "Splitting should not add latency");
+
+            const auto signal = createNoise(2, 20000);
+            auto expected = juce::AudioBuffer<float>(signal);
+            OnePole reference;
+            reference.process(expected);
+
+            OnePole stage;
+            int numOversized = 0;
+            const auto output = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block)
+            {
+                adapter.process(block, [&] (juce::AudioBuffer<float>& quantum)
+                {
+                    numOversized += quantum.getNumSamples() > 32 ? 1 : 0;
+                    stage.process(quantum);
+                });
+            });
+
+            expectEquals(numOversized, 0, "No piece should exceed the quantum");
+            expect(isDelayedCopy(output, expected, 0), "Output should match processing the whole signal at once");
+        }
+
+        beginTest("Fixed-Length Kernels Match Dynamic Ones");
+        {
+            const auto signal = createNoise(2, 64);
+            std::vector<float> ramp(64);
+            for (int i = 0; i < 64; ++i)
+                ramp[(size_t) i] = 0.5f + (float) i / 128.0f;
+
+            for (int numChannels = 1; numChannels <= 2; ++numChannels)
+            {
+                juce::AudioBuffer<float> fixed(numChannels, 64), dynamic(numChannels, 64);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    fixed.copyFrom(ch, 0, signal, ch, 0, 64);
+                    dynamic.copyFrom(ch, 0, signal, ch, 0, 64);
+                }
+
+                ChannelKernels::dispatch(numChannels, [&] (auto channelCount)
+                {
+                    constexpr int N = decltype (channelCount)::value;
+                    ChannelKernels::applyGain<N, 64>(fixed.getArrayOfWritePointers(), numChannels, 0.7f, 64);
+                    ChannelKernels::applyGainRamp<N, 64>(fixed.getArrayOfWritePointers(), numChannels, ramp.data(), 64);
+                    ChannelKernels::applyGain<N>(dynamic.getArrayOfWritePointers(), numChannels, 0.7f, 64);
+                    ChannelKernels::applyGainRamp<N>(dynamic.getArrayOfWritePointers(), numChannels, ramp.data(), 64);
+                });
+
+                expect(isDelayedCopy(fixed, dynamic, 0), juce::String(numChannels) + " channels: fixed-length kernels should match");
+            }
+        }
+
+        beginTest("Flat Equaliser Is Bypassed");
+        {
+            EqualiserStage eq;
+            eq.prepare(48000.0, 512, 2);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::Random random(7);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 512; ++i)
+                    buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+
+            juce::AudioBuffer<float> original(buffer);
+            eq.process(buffer);
+
+            expectEquals(eq.getNumActiveBands(), 0, "No band should run at 0 dB");
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 512; ++i)
+                    expectEquals(buffer.getSample(ch, i), original.getSample(ch, i));
+        }
+
+        beginTest("Equaliser Boosts At Band Centre On Every Channel");
+        {
+            // Six channels spans more than one SIMD register on every platform
+            constexpr int numChannels = 6;
+            EqualiserStage eq;
+            eq.setBand(0, 1000.0f, 12.0f, 1.0f);
+            eq.prepare(48000.0, 480, numChannels);
+            expectEquals(eq.getNumActiveBands(), 1);
+
+            const auto gainDb = processSineRmsDecibels(eq, numChannels, 1000.0, 1.0f);
+            for (int ch = 0; ch < numChannels; ++ch)
+                expectWithinAbsoluteError(gainDb[ch], 12.0f, 0.2f, "Channel " + juce::String(ch) + " should be boosted by 12 dB");
+        }
+
+        beginTest("Multiband Compressor Sums Flat At Unity Ratio");
+        {
+            for (auto frequency : { 60.0, 200.0, 1000.0, 2000.0, 8000.0 })
+            {
+                MultibandCompressor compressor;
+                compressor.setEnabled(true);
+                compressor.prepare(48000.0, 480, 2);
+
+                const auto gainDb = processSineRmsDecibels(compressor, 2, frequency, 0.5f);
+                for (auto g : gainDb)
+                    expectWithinAbsoluteError(g, 0.0f, 0.1f, "Crossover bands should recombine flat at " + juce::String(frequency) + " Hz");
+            }
+        }
+
+        beginTest("Multiband Compressor Reduces Loud Bands");
+        {
+            MultibandCompressor compressor;
+            compressor.setEnabled(true);
+            for (int band = 0; band < MultibandCompressor::numBands; ++band)
+                compressor.setBand(band, -30.0f, 4.0f);
+            compressor.prepare(48000.0, 480, 2);
+
+            const auto gainDb = processSineRmsDecibels(compressor, 2, 1000.0, 0.5f);
+            for (auto g : gainDb)
+                expect(g < -12.0f, "A sine 24 dB over threshold at 4:1 should lose about 18 dB, got " + juce::String(g));
+
+            expect(compressor.getGainReductionDecibels(1) > 12.0f, "The mid band should report its gain reduction");
+        }
+
+        beginTest("Sliding Maximum Matches Brute Force");
+        {
+            juce::Random random(3);
+            std::vector<float> values(2000);
+            for (auto& v : values)
+                v = random.nextFloat();
+
+            for (auto windowSize : { 1, 2, 5, 64, 300 })
+            {
+                SlidingMaximum window;
+                window.setWindowSize(windowSize);
+                bool allMatch = true;
+
+                for (int i = 0; i < (int) values.size(); ++i)
+                {
+                    const auto first = values.begin() + juce::jmax(0, i + 1 - windowSize);
+                    allMatch = allMatch && window.push(values[(size_t) i]) == *std::max_element(first, values.begin() + i + 1);
+                }
+
+                expect(allMatch, "Window of " + juce::String(windowSize) + " should give the maximum of its last values");
+            }
+        }
+
+        beginTest("Lookahead Limiter Delays By Its Latency Below The Ceiling");
+        {
+            LookaheadLimiter limiter;
+            limiter.setEnabled(true);
+            limiter.prepare(48000.0, 512, 2);
+
+            auto signal = createNoise(2, 24000);
+            signal.applyGain(0.5f);
+
+            const auto output = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block) { limiter.process(block); });
+            expect(isDelayedCopy(output, signal, limiter.getLatencySamples()), "Quiet audio should pass untouched, only delayed");
+            expectEquals(limiter.getGainReductionDecibels(), 0.0f, "No gain reduction below the ceiling");
+        }
+
+        beginTest("Lookahead Limiter Never Exceeds The Ceiling");
+        {
+            for (auto lookaheadMs : { 0.1f, 1.5f, 10.0f })
+            {
+                LookaheadLimiter limiter;
+                limiter.setEnabled(true);
+                limiter.setCeiling(-1.0f);
+                limiter.setLookahead(lookaheadMs);
+                limiter.prepare(48000.0, 512, 2);
+
+                // Bursts of noise up to +12 dB, so the gain has to dive and recover repeatedly
+                auto signal = createNoise(2, 48000);
+                for (int i = 0; i < signal.getNumSamples(); ++i)
+                    for (int ch = 0; ch < 2; ++ch)
+                        signal.setSample(ch, i, signal.getSample(ch, i) * ((i / 3000) % 2 == 0 ? 4.0f : 0.2f));
+
+                const auto output = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block) { limiter.process(block); });
+                const auto peak = juce::jmax(output.getMagnitude(0, 0, output.getNumSamples()), output.getMagnitude(1, 0, output.getNumSamples()));
+
+                expect(peak <= juce::Decibels::decibelsToGain(-1.0f) * 1.0001f,
+                       "Peaks should stay under -1 dB with " + juce::String(lookaheadMs) + " ms lookahead, got " + juce::String(peak));
+                expect(limiter.getGainReductionDecibels() > 0.0f, "The limiter should report its gain reduction");
+            }
+        }
+
+        beginTest("Lookahead Limiter Catches Peaks Between Samples");
+        {
+            LookaheadLimiter limiter;
+            limiter.setEnabled(true);
+            limiter.setCeiling(-1.0f);
+            limiter.prepare(48000.0, 512, 1);
+
+            // A quarter of the rate, 45 degrees out: every sample lands 3 dB below the waveform's +6 dB peaks
+            juce::AudioBuffer<float> signal(1, 48000);
+            for (int i = 0; i < signal.getNumSamples(); ++i)
+                signal.setSample(0, i, 2.0f * (float) std::sin(juce::MathConstants<double>::halfPi * i + juce::MathConstants<double>::pi / 4.0));
+
+            const auto output = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block) { limiter.process(block); });
+            const auto samplePeakDb = juce::Decibels::gainToDecibels(output.getMagnitude(0, 24000, 24000));
+
+            expectWithinAbsoluteError(samplePeakDb, -4.0f, 0.2f, "The true peak, not the samples, should sit at the -1 dB ceiling");
+        }
+
+        beginTest("Lookahead Limiter Bypass Keeps Its Delay");
+        {
+            LookaheadLimiter limiter;
+            limiter.setCeiling(-1.0f);
+            limiter.prepare(48000.0, 512, 2);
+
+            // Well over the ceiling, but switched off: delayed, never limited
+            auto signal = createNoise(2, 24000);
+            signal.applyGain(4.0f);
+
+            const auto bypassed = processInIrregularBlocks(signal, [&] (juce::AudioBuffer<float>& block) { limiter.process(block); });
+            expect(isDelayedCopy(bypassed, signal, limiter.getLatencySamples()), "Bypassed audio should only be delayed");
+
+            // Switching on fades the gain in rather than resetting the delay line
+            limiter.setEnabled(true);
+            juce::AudioBuffer<float> block(2, 24000);
+            block.makeCopyOf(signal);
+            limiter.process(block);
+
+            const auto ceiling = juce::Decibels::decibelsToGain(-1.0f) * 1.0001f;
+            const auto fadeSamples = juce::roundToInt(LookaheadLimiter::bypassFadeMilliseconds * 48.0f);
+
+            expect(block.getMagnitude(0, fadeSamples, block.getNumSamples() - fadeSamples) <= ceiling
+                       && block.getMagnitude(1, fadeSamples, block.getNumSamples() - fadeSamples) <= ceiling,
+                   "The limiter should hold the ceiling once the fade is over");
+            expect(block.getMagnitude(0, 0, fadeSamples) > 0.0f, "The delay line should still hold the audio from before");
+        }
+
+        beginTest("Processor Reports Limiter Latency");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            auto* enabled = processor.apvts.getParameter(Params::limiterEnabled.id);
+
+            enabled->setValueNotifyingHost(1.0f);
+            processor.prepareToPlay(48000.0, 512);
+            expectEquals(processor.getLatencySamples(), quantumLatency + limiterLatency(48000.0), "The limiter's lookahead should be reported");
+
+            // Switching it off only bypasses the gain, so the host never sees the latency change
+            enabled->setValueNotifyingHost(0.0f);
+            processor.prepareToPlay(48000.0, 512);
+            expectEquals(processor.getLatencySamples(), quantumLatency + limiterLatency(48000.0), "The limiter's delay should stay with it off");
+        }
+    }
+
+private:
+    /** What the processor's quantum FIFO adds at the host rate, when built with VSTP_PROCESSING_QUANTUM and VSTP_QUANTUM_FIFO. */
+    static constexpr int quantumLatency = FixedBlockAdapter<VstTestPlaygroundAudioProcessor::processingQuantum,
+                                                            VSTP_QUANTUM_FIFO != 0>::usesFifo
+                                              ? VstTestPlaygroundAudioProcessor::processingQuantum : 0;
+
+    /** The processor's limiter latency at sampleRate, with the default lookahead. */
+    static int limiterLatency(double sampleRate)
+    {
+        LookaheadLimiter limiter;
+        limiter.prepare(sampleRate, 512, 2);
+        return limiter.getLatencySamples();
+    }
+
+    /** A stateful stage, so splitting a block in the wrong place shows up in the output. */
+    struct OnePole
+    {
+        float state[2] {};
+
+        void process(juce::AudioBuffer<float>& block)
+        {
+            for (int ch = 0; ch < block.getNumChannels(); ++ch)
+                for (int i = 0; i < block.getNumSamples(); ++i)
+                    block.setSample(ch, i, state[ch] += 0.1f * (block.getSample(ch, i) - state[ch]));
+        }
+    };
+
+    static juce::AudioBuffer<float> createNoise(int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> noise(numChannels, numSamples);
+        juce::Random random(7);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return noise;
+    }
+
+    /** Runs processBlock over a copy of signal in irregular host blocks, including 1-3 samples and oversized ones. */
+    template <typename ProcessBlock>
+    static juce::AudioBuffer<float> processInIrregularBlocks(const juce::AudioBuffer<float>& signal, ProcessBlock&& processBlock)
+    {
+        juce::AudioBuffer<float> output(signal);
+        juce::Random random(42);
+
+        for (int pos = 0; pos < output.getNumSamples();)
+        {
+            const auto num = juce::jmin(random.nextBool() ? 1 + random.nextInt(3) : 1 + random.nextInt(700),
+                                        output.getNumSamples() - pos);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), output.getNumChannels(), pos, num);
+            processBlock(block);
+            pos += num;
+        }
+
+        return output;
+    }
+
+    /** True if output is silent for delay samples and then exactly expected. */
+    static bool isDelayedCopy(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& expected, int delay)
+    {
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+            for (int i = 0; i < output.getNumSamples(); ++i)
+                if (output.getSample(ch, i) != (i < delay ? 0.0f : expected.getSample(ch, i - delay)))
+                    return false;
+
+        return true;
+    }
+
+    /** Feeds a one-second sine to every channel and returns each channel's gain over the last half, in dB. */
+    template <typename Stage>
+    std::vector<float> processSineRmsDecibels(Stage& stage, int numChannels, double frequency, float amplitude)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 480;
+        constexpr int numBlocks = 100;
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        std::vector<double> inputSquares((size_t) numChannels), outputSquares((size_t) numChannels);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, amplitude * (float) std::sin(juce::MathConstants<double>::twoPi * frequency
+                                                                         * (block * blockSize + i) / sampleRate));
+
+            if (block >= numBlocks / 2)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        inputSquares[(size_t) ch] += juce::square((double) buffer.getSample(ch, i));
+
+            stage.process(buffer);
+
+            if (block >= numBlocks / 2)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        outputSquares[(size_t) ch] += juce::square((double) buffer.getSample(ch, i));
+        }
+
+        std::vector<float> gainDb;
+        for (int ch = 0; ch < numChannels; ++ch)
+            gainDb.push_back((float) (10.0 * std::log10(outputSquares[(size_t) ch] / inputSquares[(size_t) ch])));
+
+        return gainDb;
+    }
+};
+
+// Register the test suite
+static DSPTests dspTests;
@@ -0,0 +1,210 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/Params.h"
+
+/**
+ * Deterministic Render Tests for VstTestPlayground
+ * Tests that seeded renders repeat bit for bit, whatever thread runs them, and the render cache key
+ */
+class DeterministicRenderTests : public juce::UnitTest
+{
+public:
+    DeterministicRenderTests() : juce::UnitTest("Deterministic Render Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Drift Renders Identically Across Runs");
+        {
+            const auto first = renderSequentially(0.8f);
+            const auto second = renderSequentially(0.8f);
+            const auto withoutDrift = renderSequentially(0.0f);
+
+            expect(first.getMagnitude(0, first.getNumSamples()) > 0.01f, "The notes should be audible");
+            expect(isIdentical(first, second), "Two deterministic renders should match bit for bit");
+            expect(! isIdentical(first, withoutDrift), "Drift should change the output");
+        }
+
+        beginTest("Renders Identically Across Thread Counts");
+        {
+            const auto reference = renderSequentially(0.8f);
+
+            for (auto numThreads : { 1, 3, 8 })
+            {
+                const auto renders = renderOnThreadPool(numThreads, 6, 0.8f);
+
+                for (auto& render : renders)
+                    expect(isIdentical(*render, reference), "Render on " + juce::String(numThreads) + " threads differs");
+            }
+        }
+
+        beginTest("State Restored After Prepare Reseeds Drift");
+        {
+            VstTestPlaygroundAudioProcessor source;
+            source.apvts.getParameter(Params::drift.id)->setValueNotifyingHost(0.6f);
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+
+            // Prepared on one state, then restored to another before the first block
+            VstTestPlaygroundAudioProcessor restoredLate;
+            prepare(restoredLate, 0.8f);
+            restoredLate.setStateInformation(state.getData(), (int) state.getSize());
+
+            VstTestPlaygroundAudioProcessor restoredEarly;
+            restoredEarly.setStateInformation(state.getData(), (int) state.getSize());
+            prepare(restoredEarly, restoredEarly.apvts.getParameter(Params::drift.id)->getValue()); // keeps the restored drift
+
+            juce::AudioBuffer<float> input(2, 4096);
+            input.clear();
+            const auto midi = createMidi(0, 4096);
+            expectEquals((juce::int64) restoredLate.getRenderCacheKey(input, midi),
+                         (juce::int64) restoredEarly.getRenderCacheKey(input, midi), "Both end up in the same state");
+
+            expect(isIdentical(render(restoredLate), render(restoredEarly)),
+                   "The same cache key should give the same render, whenever the state arrived");
+        }
+
+        beginTest("Cache Key Follows State And Input");
+        {
+            juce::AudioBuffer<float> input(2, 4096);
+            input.clear();
+            juce::MidiBuffer midi = createMidi(0, 4096);
+
+            VstTestPlaygroundAudioProcessor a, b;
+            prepare(a, 0.0f);
+            prepare(b, 0.0f);
+
+            const auto key = a.getRenderCacheKey(input, midi);
+            expectEquals((juce::int64) b.getRenderCacheKey(input, midi), (juce::int64) key, "Same state and input, same key");
+
+            auto changedInput = juce::AudioBuffer<float>(input);
+            changedInput.setSample(1, 1000, 1.0e-6f);
+            expect(a.getRenderCacheKey(changedInput, midi) != key, "A changed sample should change the key");
+
+            juce::MidiBuffer changedMidi(midi);
+            changedMidi.addEvent(juce::MidiMessage::noteOn(1, 40, (juce::uint8) 1), 4000);
+            expect(a.getRenderCacheKey(input, changedMidi) != key, "A changed MIDI event should change the key");
+
+            b.apvts.getParameter(Params::drift.id)->setValueNotifyingHost(0.5f);
+            expect(b.getRenderCacheKey(input, midi) != key, "A changed parameter should change the key");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numBlocks = 200;
+
+    //==============================================================================
+    /** A few overlapping chords, so drift gets many notes to seed. */
+    static juce::MidiBuffer createMidi(int blockStart, int numSamples)
+    {
+        juce::MidiBuffer midi;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto position = blockStart + i;
+
+            if (position % 4800 == 0)
+                for (auto note : { 48, 55, 60, 64 })
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note + (position / 4800) % 5, (juce::uint8) 100), i);
+
+            if (position % 4800 == 3600)
+                midi.addEvent(juce::MidiMessage::allNotesOff(1), i);
+        }
+
+        return midi;
+    }
+
+    static void prepare(VstTestPlaygroundAudioProcessor& processor, float drift)
+    {
+        processor.setDeterministicRender(true);
+        processor.apvts.getParameter(Params::drift.id)->setValueNotifyingHost(drift);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    /** Renders the next block of a stem; the input is silent, so the output is the voices alone. */
+    static void renderBlock(VstTestPlaygroundAudioProcessor& processor, juce::AudioBuffer<float>& output, int block)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        buffer.clear();
+        auto midi = createMidi(block * blockSize, blockSize);
+        processor.processBlock(buffer, midi);
+
+        for (int ch = 0; ch < 2; ++ch)
+            output.copyFrom(ch, block * blockSize, buffer, ch, 0, blockSize);
+    }
+
+    static juce::AudioBuffer<float> renderSequentially(float drift)
+    {
+        VstTestPlaygroundAudioProcessor processor;
+        prepare(processor, drift);
+        return render(processor);
+    }
+
+    static juce::AudioBuffer<float> render(VstTestPlaygroundAudioProcessor& processor)
+    {
+        juce::AudioBuffer<float> output(2, numBlocks * blockSize);
+
+        for (int b = 0; b < numBlocks; ++b)
+            renderBlock(processor, output, b);
+
+        return output;
+    }
+
+    /**
+        Renders numInstances stems at once, a block of each per cycle as pool
+        jobs, so every instance hops between whichever threads are free.
+    */
+    static juce::OwnedArray<juce::AudioBuffer<float>> renderOnThreadPool(int numThreads, int numInstances, float drift)
+    {
+        juce::OwnedArray<VstTestPlaygroundAudioProcessor> processors;
+        juce::OwnedArray<juce::AudioBuffer<float>> outputs;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            prepare(*processors.add(new VstTestPlaygroundAudioProcessor()), drift);
+            outputs.add(new juce::AudioBuffer<float>(2, numBlocks * blockSize));
+        }
+
+        juce::ThreadPool pool(numThreads);
+        juce::WaitableEvent cycleDone;
+        std::atomic<int> remaining { 0 };
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            remaining.store(numInstances);
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                pool.addJob([&processor = *processors[i], &output = *outputs[i], b, &remaining, &cycleDone]
+                {
+                    renderBlock(processor, output, b);
+
+                    if (remaining.fetch_sub(1) == 1)
+                        cycleDone.signal();
+                });
+            }
+
+            cycleDone.wait();
+        }
+
+        return outputs;
+    }
+
+    static bool isIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch), sizeof(float) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+// Register the test suite
+static DeterministicRenderTests deterministicRenderTests;
@@ -0,0 +1,203 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/ExecutionContext.h"
+
+/**
+ * Execution Context Tests for VstTestPlayground
+ * Tests denormal flushing and per-thread stats on the audio thread and on every worker
+ */
+class ExecutionContextTests : public juce::UnitTest
+{
+public:
+    ExecutionContextTests() : juce::UnitTest("Execution Context Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        // Stats last only as long as someone holds the context
+        juce::SharedResourcePointer<ExecutionContext> context;
+
+        beginTest("Worker Cycles Flush Denormals");
+        {
+            bool disabledInCycle = false;
+            float tail = 0.0f;
+
+            runOnNewThread("Denormal test worker", [&] (ExecutionContext::ThreadScope& scope)
+            {
+                const ExecutionContext::ScopedCycle cycle(scope);
+                disabledInCycle = juce::FloatVectorOperations::areDenormalsDisabled();
+
+                // A decaying tail, like a reverb's after the input stops
+                volatile float decay = 0.5f;
+                tail = std::numeric_limits<float>::min();
+                for (int i = 0; i < 10; ++i)
+                    tail *= decay;
+            });
+
+            expect(disabledInCycle, "FTZ/DAZ should be on inside a cycle");
+            expectEquals(tail, 0.0f, "Values below the normal range should flush to zero");
+
+            const auto stats = findStats(*context, "Denormal test worker");
+            expect(stats.denormalsDisabled, "The stats should show denormals disabled");
+            expect(! stats.running, "The thread has finished");
+        }
+
+        beginTest("Restarted Threads Keep Their Stats");
+        {
+            for (int run = 0; run < 3; ++run)
+            {
+                runOnNewThread("Restarted test worker", [] (ExecutionContext::ThreadScope& scope)
+                {
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        const ExecutionContext::ScopedCycle cycle(scope);
+                    }
+                });
+            }
+
+            auto numEntries = 0;
+            for (const auto& stats : context->getStats())
+                numEntries += stats.name == "Restarted test worker" ? 1 : 0;
+
+            expectEquals(numEntries, 1, "Each restart should reuse the stopped thread's entry");
+            expectEquals((int) findStats(*context, "Restarted test worker").cycles, 6, "Cycles should add up across restarts");
+        }
+
+        beginTest("Audio Scopes Stay Out Of The Thread Table");
+        {
+            const auto numEntries = (int) context->getStats().size();
+
+            // More instances than the table has slots, as a large session would load
+            juce::OwnedArray<ExecutionContext::ThreadScope> scopes;
+            for (int i = 0; i < ExecutionContext::maxThreads + 8; ++i)
+                scopes.add(new ExecutionContext::ThreadScope("Audio", ExecutionContext::Role::audio));
+
+            expectEquals((int) context->getStats().size(), numEntries, "Audio scopes shouldn't take shared slots");
+
+            {
+                const ExecutionContext::ScopedCycle cycle(*scopes.getLast());
+            }
+
+            const auto stats = scopes.getLast()->getStats();
+            expectEquals((int) stats.cycles, 1, "The last instance should still count its cycles");
+            expect(stats.running && stats.denormalsDisabled, "And report them like a registered thread");
+
+            auto workerRegistered = false;
+            runOnNewThread("Worker beside many instances", [] (ExecutionContext::ThreadScope&) {});
+
+            for (const auto& entry : context->getStats())
+                workerRegistered = workerRegistered || entry.name == "Worker beside many instances";
+
+            expect(workerRegistered, "Workers should still find a slot");
+        }
+
+        beginTest("Processor Threads Report Stats");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            processor.prepareToPlay(48000.0, 512);
+
+            const auto audioCyclesBefore = countCycles(processor, "Audio");
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), 512);
+
+            for (int block = 0; block < 10; ++block)
+            {
+                juce::MidiBuffer midi;
+                buffer.clear();
+                processor.processBlock(buffer, midi);
+            }
+
+            expect(countCycles(processor, "Audio") >= audioCyclesBefore + 10, "Every block should count as an audio cycle");
+
+            // The analyser picks the blocks up on its own thread
+            bool analyserRan = false;
+            for (int attempt = 0; attempt < 200 && ! analyserRan; ++attempt)
+            {
+                juce::Thread::sleep(10);
+
+                for (const auto& stats : processor.getThreadStats())
+                    analyserRan = analyserRan || (stats.name == "Spectrum analyser" && stats.running && stats.cycles > 0);
+            }
+
+            expect(analyserRan, "The analysis thread should report its cycles");
+
+            for (const auto& stats : processor.getThreadStats())
+                if (stats.running && stats.cycles > 0)
+                    expect(stats.denormalsDisabled, stats.name + " should run with denormals flushed");
+        }
+
+        beginTest("Instances Share Their Worker Threads");
+        {
+            juce::OwnedArray<VstTestPlaygroundAudioProcessor> processors;
+
+            for (int i = 0; i < 8; ++i)
+                processors.add(new VstTestPlaygroundAudioProcessor())->prepareToPlay(48000.0, 512);
+
+            expect(&processors[0]->getAssetLoader() == &processors[7]->getAssetLoader(), "Every instance should use the same loader");
+
+            auto countRunning = [&] (const juce::String& prefix)
+            {
+                auto count = 0;
+                for (const auto& stats : context->getStats())
+                    count += stats.running && stats.name.startsWith(prefix) ? 1 : 0;
+                return count;
+            };
+
+            // The threads register once they're running
+            for (int attempt = 0; attempt < 200; ++attempt)
+            {
+                if (countRunning("Sample streamer") > 0 && countRunning("Spectrum analyser") > 0 && countRunning("Asset loader") > 1)
+                    break;
+
+                juce::Thread::sleep(10);
+            }
+
+            expectEquals(countRunning("Sample streamer"), 1, "One I/O thread should serve every sampler");
+            expectEquals(countRunning("Spectrum analyser"), 1, "One thread should serve every analyser");
+            expectEquals(countRunning("Asset loader"), 2, "The loader's workers shouldn't multiply with instances");
+        }
+    }
+
+private:
+    /** Runs fn on a fresh thread registered as name, and waits for it to finish. */
+    template <typename Fn>
+    void runOnNewThread(const juce::String& name, Fn&& fn)
+    {
+        juce::WaitableEvent finished;
+
+        juce::Thread::launch([&]
+        {
+            {
+                ExecutionContext::ThreadScope scope(name, ExecutionContext::Role::worker);
+                fn(scope);
+            }
+
+            finished.signal();
+        });
+
+        expect(finished.wait(5000), name + " should finish");
+    }
+
+    static ExecutionContext::ThreadStats findStats(const ExecutionContext& context, const juce::String& name)
+    {
+        for (const auto& stats : context.getStats())
+            if (stats.name == name)
+                return stats;
+
+        return {};
+    }
+
+    /** Summed over every running thread called name, since other live instances may have their own. */
+    static juce::uint64 countCycles(const VstTestPlaygroundAudioProcessor& processor, const juce::String& name)
+    {
+        juce::uint64 cycles = 0;
+
+        for (const auto& stats : processor.getThreadStats())
+            if (stats.name == name && stats.running)
+                cycles += stats.cycles;
+
+        return cycles;
+    }
+};
+
+// Register the test suite
+static ExecutionContextTests executionContextTests;
@@ -1,4 +1,4 @@
-#include <JuceHeader.h>
+#include <juce_gui_basics/juce_gui_basics.h>
 
 class TestRunnerApplication : public juce::JUCEApplication
 {
@@ -12,7 +12,26 @@ public:
     void initialise (const juce::String& commandLine) override
     {
         juce::UnitTestRunner runner;
-        runner.runAllTests();
+
+        // "--category <name>" runs a single category, e.g. the headless Render suite
+        auto args = juce::StringArray::fromTokens (commandLine, true);
+        auto categoryIndex = args.indexOf ("--category");
+
+        if (categoryIndex >= 0 && categoryIndex + 1 < args.size())
+        {
+            runner.runTestsInCategory (args[categoryIndex + 1].unquoted());
+        }
+        else
+        {
+            // The CPU budget compares against a baseline from this machine, so it only runs when asked for by name
+            juce::Array<juce::UnitTest*> tests;
+
+            for (auto* test : juce::UnitTest::getAllTests())
+                if (test->getCategory() != "Performance")
+                    tests.add (test);
+
+            runner.runTests (tests);
+        }
 
         int numFailures = 0;
         for (int i = 0; i < runner.getNumResults(); ++i)
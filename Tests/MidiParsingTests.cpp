@@ -0,0 +1,149 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PreparsedMidiBuffer.h"
+
+/**
+ * MIDI Parsing Tests for VstTestPlayground
+ * Tests that PreparsedMidiBuffer decodes MidiBuffer contents into typed events
+ */
+class MidiParsingTests : public juce::UnitTest
+{
+public:
+    MidiParsingTests() : juce::UnitTest("MIDI Parsing Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        using Type = PreparsedMidiBuffer::Event::Type;
+
+        beginTest("Notes Are Decoded In Sample Order");
+        {
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 127), 10);
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 0), 20);
+            midi.addEvent(juce::MidiMessage::noteOff(2, 64, (juce::uint8) 32), 5);
+            midi.addEvent(juce::MidiMessage::noteOn(3, 67, (juce::uint8) 100), 900);
+
+            PreparsedMidiBuffer parsed;
+            parsed.parse(midi, 512);
+
+            expectEquals(parsed.size(), 4);
+            expect(parsed[0].type == Type::noteOff && parsed[0].sampleOffset == 5 && parsed[0].channel == 2);
+            expect(parsed[1].type == Type::noteOn && parsed[1].note == 60);
+            expectEquals((int) parsed[1].value, 0xffff, "Full velocity should upscale to full 16-bit scale");
+            expect(parsed[2].type == Type::noteOff, "Velocity 0 note-on should become a note-off");
+            expectEquals(parsed[3].sampleOffset, 511, "Offsets past the block should be clamped");
+
+            expect(parsed.lowerBound(11) == parsed.begin() + 2);
+            expect(parsed.lowerBound(100) == parsed.begin() + 3);
+            expect(parsed.lowerBound(512) == parsed.end());
+        }
+
+        beginTest("Fourteen Bit Controllers Combine MSB And LSB");
+        {
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 1, 64), 0);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 33, 10), 1);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 74, 127), 2);
+
+            PreparsedMidiBuffer parsed;
+            parsed.parse(midi, 64);
+
+            expectEquals(parsed.size(), 3);
+            expectEquals((int) parsed[1].number, 1, "The LSB should be reported against its MSB controller");
+            expectWithinAbsoluteError(parsed[1].normalised, (float) ((64 << 7) | 10) / 16383.0f, 1.0e-6f);
+            expectEquals((juce::int64) parsed[2].value, (juce::int64) 0xffffffffu, "7-bit controllers should upscale to full scale");
+        }
+
+        beginTest("Controllers Without An LSB Are Seven Bit");
+        {
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 7, 127), 0);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 39, 0), 1);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 7, 127), 2);
+
+            PreparsedMidiBuffer parsed;
+            parsed.parse(midi, 64);
+
+            expectEquals(parsed.size(), 3);
+            expectEquals(parsed[0].normalised, 1.0f, "An MSB on its own should reach full scale");
+            expectEquals((juce::int64) parsed[0].value, (juce::int64) 0xffffffffu);
+            expectWithinAbsoluteError(parsed[2].normalised, (float) (127 << 7) / 16383.0f, 1.0e-6f,
+                                      "Once an LSB has arrived the MSB should count as 14-bit");
+        }
+
+        beginTest("Data Increment And Decrement Pass Through");
+        {
+            auto midi = juce::MidiRPNGenerator::generate(1, 0, 12, false, false);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 96, 0), 1);
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, 97, 0), 2);
+
+            PreparsedMidiBuffer parsed;
+            parsed.parse(midi, 64);
+
+            expectEquals(parsed.size(), 3, "Increment and decrement shouldn't be swallowed");
+            expect(parsed[1].type == Type::controller && parsed[1].number == 96);
+            expect(parsed[2].type == Type::controller && parsed[2].number == 97);
+        }
+
+        beginTest("Pitch Bend Uses The Channel's Bend Range");
+        {
+            auto midi = juce::MidiRPNGenerator::generate(1, 0, 12, false, false);
+            midi.addEvent(juce::MidiMessage::pitchWheel(1, 16383), 1);
+            midi.addEvent(juce::MidiMessage::pitchWheel(2, 0), 2);
+
+            PreparsedMidiBuffer parsed;
+            parsed.parse(midi, 64);
+
+            expect(parsed[0].type == Type::parameter && parsed[0].number == 0);
+            expect(parsed[1].type == Type::pitchBend);
+            expectWithinAbsoluteError(parsed[1].semitones, 12.0f, 1.0e-4f);
+            expectWithinAbsoluteError(parsed[2].semitones, -2.0f, 1.0e-4f, "Other channels should keep the default range");
+        }
+
+        beginTest("MPE Member Channels Are Per-Note");
+        {
+            PreparsedMidiBuffer parsed;
+
+            auto midi = juce::MPEMessages::setLowerZone(15);
+            parsed.parse(midi, 64);
+            expect(parsed.getZoneLayout().getLowerZone().isActive(), "The MCM should configure a lower zone");
+
+            midi.clear();
+            midi.addEvent(juce::MidiMessage::noteOn(2, 60, (juce::uint8) 100), 0);
+            midi.addEvent(juce::MidiMessage::pitchWheel(2, 16383), 1);
+            midi.addEvent(juce::MidiMessage::channelPressureChange(2, 64), 2);
+            midi.addEvent(juce::MidiMessage::pitchWheel(1, 16383), 3);
+            parsed.parse(midi, 64);
+
+            expect(parsed[0].perNote && parsed[1].perNote && parsed[2].perNote);
+            expectWithinAbsoluteError(parsed[1].semitones, 48.0f, 1.0e-3f, "Member channels default to 48 semitones");
+            expect(! parsed[3].perNote, "The master channel is not per-note");
+            expectWithinAbsoluteError(parsed[3].semitones, 2.0f, 1.0e-3f);
+        }
+
+        beginTest("Capacity Is Fixed");
+        {
+            juce::MidiBuffer midi;
+            for (int i = 0; i < 10; ++i)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 60 + i, (juce::uint8) 100), i);
+
+            PreparsedMidiBuffer parsed(4);
+            parsed.parse(midi, 64);
+
+            expectEquals(parsed.size(), 4);
+            expectEquals(parsed.getNumDropped(), 6);
+        }
+
+        beginTest("MIDI 2.0 Upscaling");
+        {
+            expectEquals((int) PreparsedMidiBuffer::scaleUp(0, 7, 16), 0);
+            expectEquals((int) PreparsedMidiBuffer::scaleUp(64, 7, 16), 0x8000);
+            expectEquals((int) PreparsedMidiBuffer::scaleUp(127, 7, 16), 0xffff);
+            expectEquals((juce::int64) PreparsedMidiBuffer::scaleUp(8192, 14, 32), (juce::int64) 0x80000000u);
+            expectEquals((juce::int64) PreparsedMidiBuffer::scaleUp(16383, 14, 32), (juce::int64) 0xffffffffu);
+        }
+    }
+};
+
+// Register the test suite
+static MidiParsingTests midiParsingTests;
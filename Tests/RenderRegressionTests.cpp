@@ -0,0 +1,356 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/Params.h"
+#include "TestHelpers.h"
+
+/**
+ * Render Regression Tests for VstTestPlayground
+ *
+ * Runs deterministic audio/MIDI scenarios through processBlock and compares the
+ * output against reference renders stored in Tests/GoldenRenders. Only the
+ * processor is instantiated, so the suite runs headless without a WebView:
+ *
+ *     VstTestPlayground_Tests --category Render
+ *     VstTestPlayground_Tests --category Performance
+ *
+ * A missing reference fails its scenario. References are only ever written
+ * with VSTP_UPDATE_GOLDEN=1 set: run that way to record them, or to re-record
+ * after an intentional change in output, and commit the results.
+ *
+ * The Performance category is left out of the default run; see
+ * RenderPerformanceTests.
+ */
+namespace
+{
+    struct RenderScenario
+    {
+        juce::String name;
+        juce::AudioChannelSet layout;
+        double sampleRate;
+        int preparedBlockSize;
+        juce::Array<int> blockSizes;    /**< Cycled through until totalSamples are rendered. */
+        int totalSamples;
+        float tolerance;                /**< Maximum absolute error; 0 means bit-exact. */
+        std::function<void (VstTestPlaygroundAudioProcessor&, int blockIndex)> automate;
+        std::function<void (juce::MidiBuffer&, int blockStart, int numSamples)> generateMidi;
+    };
+
+    //==============================================================================
+    void fillInput(juce::AudioBuffer<float>& buffer, int blockStart, double sampleRate, juce::Random& noise)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const auto frequency = 110.0 * (ch + 1);
+            auto* data = buffer.getWritePointer(ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const auto phase = juce::MathConstants<double>::twoPi * frequency * (blockStart + i) / sampleRate;
+                data[i] = 0.5f * (float) std::sin(phase) + 0.05f * (noise.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+    }
+
+    void setGainDecibels(VstTestPlaygroundAudioProcessor& processor, float decibels)
+    {
+        auto* param = processor.apvts.getParameter(Params::GAIN_ID);
+        param->setValueNotifyingHost(param->convertTo0to1(decibels));
+    }
+
+    juce::Array<RenderScenario> createScenarios()
+    {
+        juce::Array<RenderScenario> scenarios;
+
+        scenarios.add({ "stereo_unity_gain", juce::AudioChannelSet::stereo(), 44100.0, 512, { 512 },
+                        44100, 0.0f, nullptr, nullptr });
+
+        scenarios.add({ "stereo_gain_automation", juce::AudioChannelSet::stereo(), 48000.0, 256, { 256 },
+                        48000, 1.0e-6f,
+                        [] (VstTestPlaygroundAudioProcessor& p, int block)
+                        {
+                            setGainDecibels(p, -48.0f + (float) ((block * 7) % 60));
+                        },
+                        nullptr });
+
+        scenarios.add({ "mono_irregular_blocks", juce::AudioChannelSet::mono(), 44100.0, 256, { 1, 3, 64, 480, 1024, 17 },
+                        22050, 1.0e-6f,
+                        [] (VstTestPlaygroundAudioProcessor& p, int block)
+                        {
+                            if (block % 11 == 0)
+                                setGainDecibels(p, block % 2 == 0 ? 6.0f : -12.0f);
+                        },
+                        nullptr });
+
+        scenarios.add({ "surround_7_1_4", juce::AudioChannelSet::create7point1point4(), 48000.0, 512, { 512 },
+                        24000, 0.0f, nullptr, nullptr });
+
+        // The notes now play voices, whose std::sin/std::exp2 output may differ in the last bits between C libraries
+        scenarios.add({ "stereo_midi_sequence", juce::AudioChannelSet::stereo(), 44100.0, 512, { 512 },
+                        44100, 1.0e-5f, nullptr,
+                        [] (juce::MidiBuffer& midi, int blockStart, int numSamples)
+                        {
+                            // A note every 2205 samples, alternating between two pitches.
+                            constexpr int spacing = 2205;
+
+                            for (int pos = ((blockStart + spacing - 1) / spacing) * spacing; pos < blockStart + numSamples; pos += spacing)
+                            {
+                                const auto note = (pos / spacing) % 2 == 0 ? 60 : 67;
+                                midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 100), pos - blockStart);
+                                midi.addEvent(juce::MidiMessage::noteOff(1, note == 60 ? 67 : 60), pos - blockStart);
+                            }
+                        } });
+
+        return scenarios;
+    }
+
+    //==============================================================================
+    /** Renders a scenario and returns the time spent inside processBlock in seconds. */
+    double render(const RenderScenario& scenario, juce::AudioBuffer<float>& output)
+    {
+        VstTestPlaygroundAudioProcessor processor;
+
+        auto layout = processor.getBusesLayout();
+        layout.getMainOutputChannelSet() = scenario.layout;
+       #if ! JucePlugin_IsSynth
+        layout.getMainInputChannelSet() = scenario.layout;
+       #endif
+        processor.setBusesLayout(layout);
+
+        processor.setRateAndBufferSizeDetails(scenario.sampleRate, scenario.preparedBlockSize);
+        processor.prepareToPlay(scenario.sampleRate, scenario.preparedBlockSize);
+
+        const auto numChannels = scenario.layout.size();
+        const auto bufferChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        const auto maxBlockSize = juce::jmax(scenario.preparedBlockSize, *std::max_element(scenario.blockSizes.begin(), scenario.blockSizes.end()));
+
+        juce::AudioBuffer<float> block(bufferChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+        juce::Random noise(0x601d);
+
+        output.setSize(numChannels, scenario.totalSamples);
+        output.clear();
+
+        juce::int64 ticks = 0;
+        int blockIndex = 0;
+
+        for (int pos = 0; pos < scenario.totalSamples; ++blockIndex)
+        {
+            const auto numSamples = juce::jmin(scenario.blockSizes[blockIndex % scenario.blockSizes.size()],
+                                               scenario.totalSamples - pos);
+
+            block.setSize(bufferChannels, numSamples, false, false, true);
+            block.clear();
+            midi.clear();
+
+            juce::AudioBuffer<float> mainInput(block.getArrayOfWritePointers(), numChannels, numSamples);
+            fillInput(mainInput, pos, scenario.sampleRate, noise);
+
+            if (scenario.automate != nullptr)
+                scenario.automate(processor, blockIndex);
+
+            if (scenario.generateMidi != nullptr)
+                scenario.generateMidi(midi, pos, numSamples);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.copyFrom(ch, pos, block, ch, 0, numSamples);
+
+            pos += numSamples;
+        }
+
+        processor.releaseResources();
+        return juce::Time::highResolutionTicksToSeconds(ticks);
+    }
+
+    //==============================================================================
+    juce::File getGoldenDirectory()
+    {
+        auto overridePath = juce::SystemStats::getEnvironmentVariable("VSTP_GOLDEN_DIR", {});
+
+        if (overridePath.isNotEmpty())
+            return juce::File(overridePath);
+
+       #ifdef VSTP_GOLDEN_RENDER_DIR
+        return juce::File(VSTP_GOLDEN_RENDER_DIR);
+       #else
+        return juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                   .getParentDirectory().getChildFile("GoldenRenders");
+       #endif
+    }
+
+    bool shouldUpdateReferences()
+    {
+        return juce::SystemStats::getEnvironmentVariable("VSTP_UPDATE_GOLDEN", "0") == "1";
+    }
+
+    bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+}
+
+//==============================================================================
+class RenderRegressionTests : public juce::UnitTest
+{
+public:
+    RenderRegressionTests() : juce::UnitTest("Render Regression Tests for VstTestPlayground", "Render") {}
+
+    void runTest() override
+    {
+        const auto directory = getGoldenDirectory();
+
+        for (const auto& scenario : createScenarios())
+        {
+            beginTest("Scenario: " + scenario.name);
+
+            juce::AudioBuffer<float> rendered;
+            render(scenario, rendered);
+
+            juce::AudioBuffer<float> second;
+            render(scenario, second);
+            expect(maxDifference(rendered, second).error == 0.0f, "Rendering should be deterministic between runs");
+
+            const auto file = directory.getChildFile(scenario.name + ".wav");
+
+            if (shouldUpdateReferences())
+            {
+                file.getParentDirectory().createDirectory();
+                expect(TestHelpers::writeWav(file, rendered, scenario.sampleRate), "Could not write " + file.getFullPathName());
+                logMessage("Recorded reference render " + file.getFullPathName());
+                continue;
+            }
+
+            if (! file.existsAsFile())
+            {
+                expect(false, "Missing reference " + file.getFullPathName() + ", run with VSTP_UPDATE_GOLDEN=1");
+                continue;
+            }
+
+            juce::AudioBuffer<float> reference;
+            expect(readReference(file, reference), "Could not read " + file.getFullPathName());
+
+            expectEquals(rendered.getNumChannels(), reference.getNumChannels(), "Channel count changed");
+            expectEquals(rendered.getNumSamples(), reference.getNumSamples(), "Render length changed");
+
+            if (rendered.getNumChannels() != reference.getNumChannels()
+                || rendered.getNumSamples() != reference.getNumSamples())
+                continue;
+
+            const auto diff = maxDifference(rendered, reference);
+            expect(diff.error <= scenario.tolerance,
+                   "Output deviates from reference by " + juce::String(diff.error, 9)
+                   + " at channel " + juce::String(diff.channel) + ", sample " + juce::String(diff.sample)
+                   + (scenario.tolerance == 0.0f ? " (bit-exact required)" : " (tolerance " + juce::String(scenario.tolerance, 9) + ")"));
+        }
+    }
+
+private:
+    struct Difference
+    {
+        float error = 0.0f;
+        int channel = -1;
+        int sample = -1;
+    };
+
+    static Difference maxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        Difference diff;
+
+        for (int ch = 0; ch < juce::jmin(a.getNumChannels(), b.getNumChannels()); ++ch)
+        {
+            for (int i = 0; i < juce::jmin(a.getNumSamples(), b.getNumSamples()); ++i)
+            {
+                const auto error = std::abs(a.getSample(ch, i) - b.getSample(ch, i));
+
+                if (error > diff.error || (diff.channel < 0 && a.getSample(ch, i) != b.getSample(ch, i)))
+                    diff = { error, ch, i };
+            }
+        }
+
+        return diff;
+    }
+};
+
+//==============================================================================
+/**
+ * Performance budget check for the render scenarios.
+ *
+ * Each scenario is rendered several times and the fastest run is compared
+ * against the baseline in GoldenRenders/perf_baseline.json. The check fails
+ * when a scenario is more than VSTP_PERF_TOLERANCE_PERCENT (default 25%)
+ * slower than its baseline, or has no baseline.
+ *
+ * Wall-clock times only compare on the machine that recorded them, so the
+ * baseline is local-only (it is git-ignored) and the check is opt-in: it
+ * runs only with "--category Performance", which CTest does when configured
+ * with -DVSTP_PERF_BUDGET=ON.
+ */
+class RenderPerformanceTests : public juce::UnitTest
+{
+public:
+    RenderPerformanceTests() : juce::UnitTest("Render Performance Budget for VstTestPlayground", "Performance") {}
+
+    void runTest() override
+    {
+        const auto baselineFile = getGoldenDirectory().getChildFile("perf_baseline.json");
+        const auto tolerancePercent = juce::SystemStats::getEnvironmentVariable("VSTP_PERF_TOLERANCE_PERCENT", "25").getDoubleValue();
+
+        auto baseline = juce::JSON::parse(baselineFile);
+        auto* baselineObject = baseline.getDynamicObject();
+        juce::DynamicObject::Ptr updated = new juce::DynamicObject();
+
+        for (const auto& scenario : createScenarios())
+        {
+            beginTest("Budget: " + scenario.name);
+
+            juce::AudioBuffer<float> rendered;
+            auto best = std::numeric_limits<double>::max();
+
+            for (int run = 0; run < 5; ++run)
+                best = juce::jmin(best, render(scenario, rendered));
+
+            const auto micros = best * 1.0e6;
+            updated->setProperty(scenario.name, micros);
+            logMessage(scenario.name + ": " + juce::String(micros, 1) + " us");
+
+            if (shouldUpdateReferences())
+                continue;
+
+            if (baselineObject == nullptr || ! baselineObject->hasProperty(scenario.name))
+            {
+                expect(false, "Missing baseline for " + scenario.name + " in " + baselineFile.getFullPathName()
+                              + ", run with VSTP_UPDATE_GOLDEN=1");
+                continue;
+            }
+
+            const auto budget = (double) baselineObject->getProperty(scenario.name) * (1.0 + tolerancePercent / 100.0);
+            expect(micros <= budget,
+                   scenario.name + " took " + juce::String(micros, 1) + " us, budget is "
+                   + juce::String(budget, 1) + " us (" + juce::String(tolerancePercent, 0) + "% over baseline)");
+        }
+
+        if (shouldUpdateReferences())
+        {
+            baselineFile.getParentDirectory().createDirectory();
+            expect(baselineFile.replaceWithText(juce::JSON::toString(juce::var(updated.get()))),
+                   "Could not write " + baselineFile.getFullPathName());
+            logMessage("Recorded performance baseline " + baselineFile.getFullPathName());
+        }
+    }
+};
+
+// Register the test suites
+static RenderRegressionTests renderRegressionTests;
+static RenderPerformanceTests renderPerformanceTests;
@@ -0,0 +1,170 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/SpectrumAnalyser.h"
+#include "../Source/Params.h"
+
+/**
+ * Spectrum Analyser Tests for VstTestPlayground
+ * Tests BS.1770 loudness against the EBU Tech 3341 cases, the spectrum, plan sharing and loudness normalisation
+ */
+class SpectrumAnalyserTests : public juce::UnitTest
+{
+public:
+    SpectrumAnalyserTests() : juce::UnitTest("Spectrum Analyser Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Stereo Sine At -23 dBFS Reads -23 LUFS");
+        {
+            SpectrumAnalyser analyser;
+            analyser.setAnalyseInline(true);
+            analyser.prepare(sampleRate, 2, blockSize);
+
+            pushSine(analyser, 1000.0, -23.0f, 20.0);
+
+            const auto& results = analyser.getLatestResults();
+            expectWithinAbsoluteError(results.momentaryLufs, -23.0f, 0.1f, "Momentary loudness");
+            expectWithinAbsoluteError(results.shortTermLufs, -23.0f, 0.1f, "Short-term loudness");
+            expectWithinAbsoluteError(results.integratedLufs, -23.0f, 0.1f, "Integrated loudness");
+            expectWithinAbsoluteError(analyser.getShortTermLoudness(), -23.0f, 0.1f, "The audio thread's copy");
+        }
+
+        beginTest("Relative Gate Ignores Quiet Passages");
+        {
+            SpectrumAnalyser analyser;
+            analyser.setAnalyseInline(true);
+            analyser.prepare(sampleRate, 2, blockSize);
+
+            pushSine(analyser, 1000.0, -36.0f, 10.0);
+            pushSine(analyser, 1000.0, -23.0f, 60.0);
+            pushSine(analyser, 1000.0, -36.0f, 10.0);
+
+            expectWithinAbsoluteError(analyser.getLatestResults().integratedLufs, -23.0f, 0.1f,
+                                      "The -36 dBFS passages fall below the relative gate");
+
+            analyser.resetIntegratedLoudness();
+            pushSine(analyser, 1000.0, -30.0f, 10.0);
+            expectWithinAbsoluteError(analyser.getLatestResults().integratedLufs, -30.0f, 0.1f,
+                                      "A reset should forget the earlier programme");
+        }
+
+        beginTest("Spectrum Peaks At The Sine's Bin");
+        {
+            SpectrumAnalyser analyser;
+            analyser.setAnalyseInline(true);
+            analyser.prepare(sampleRate, 2, blockSize);
+
+            // Exactly on bin 64, so there's no scalloping loss
+            constexpr int expectedBin = 64;
+            pushSine(analyser, expectedBin * sampleRate / SpectrumAnalyser::fftSize, -6.0f, 2.0);
+
+            const auto& results = analyser.getLatestResults();
+            const auto peak = std::max_element(std::begin(results.spectrum), std::end(results.spectrum));
+
+            expectEquals((int) (peak - std::begin(results.spectrum)), expectedBin, "Peak bin");
+            expectWithinAbsoluteError(*peak, -6.0f, 0.1f, "Peak level");
+            expect(results.spectrum[expectedBin * 4] < -60.0f, "Bins far from the sine should be quiet");
+        }
+
+        beginTest("FFT Plans Are Shared Between Instances");
+        {
+            juce::SharedResourcePointer<FftPlanCache> cache;
+
+            {
+                SpectrumAnalyser first, second;
+                expectEquals(cache->getNumPlans(), 1, "Both analysers should use the same plan");
+                expect(&cache->getPlan(SpectrumAnalyser::fftOrder) == &cache->getPlan(SpectrumAnalyser::fftOrder),
+                       "A plan should be built once");
+            }
+        }
+
+        beginTest("Analysis Thread Publishes Results");
+        {
+            SpectrumAnalyser analyser;
+            analyser.prepare(sampleRate, 2, blockSize);
+
+            // Paced, so the ring never fills
+            for (int i = 0; i < 10; ++i)
+            {
+                pushSine(analyser, 1000.0, -23.0f, 0.2);
+                juce::Thread::sleep(20);
+            }
+
+            auto loudness = SpectrumAnalyser::silenceLufs;
+
+            for (int attempt = 0; attempt < 200 && std::abs(loudness + 23.0f) > 0.1f; ++attempt)
+            {
+                juce::Thread::sleep(10);
+                loudness = analyser.getLatestResults().momentaryLufs;
+            }
+
+            expectWithinAbsoluteError(loudness, -23.0f, 0.1f, "The analysis thread should measure the pushed audio");
+            expectEquals((juce::int64) analyser.getNumDroppedSamples(), (juce::int64) 0, "Nothing should be dropped");
+        }
+
+        beginTest("Loudness Normalisation Reaches The Target");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            processor.setDeterministicRender(true); // analyses inline, so the result doesn't depend on timing
+            setParameter(processor, Params::loudnessNormalise.id, 1.0f);
+            setParameter(processor, Params::loudnessTarget.id, -20.0f);
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+
+            for (int b = 0; b < (int) (60.0 * sampleRate) / blockSize; ++b)
+            {
+                juce::MidiBuffer midi;
+
+                if (b == 0)
+                    for (auto note : { 48, 55, 64 })
+                        midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 100), 0);
+
+                buffer.clear();
+                processor.processBlock(buffer, midi);
+            }
+
+            expectWithinAbsoluteError(processor.getAnalyser().getShortTermLoudness(), -20.0f, 0.5f,
+                                      "Sustained notes should settle on the target");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    /** Pushes seconds of a sine at decibels on both channels, in blocks, continuing its phase across calls. */
+    void pushSine(SpectrumAnalyser& analyser, double frequency, float decibels, double seconds)
+    {
+        const auto amplitude = juce::Decibels::decibelsToGain(decibels);
+        juce::AudioBuffer<float> block(2, blockSize);
+
+        for (int remaining = (int) (seconds * sampleRate); remaining > 0; remaining -= blockSize)
+        {
+            const auto num = juce::jmin(blockSize, remaining);
+            block.setSize(2, num, false, false, true);
+
+            for (int i = 0; i < num; ++i)
+            {
+                const auto value = amplitude * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * (double) sinePosition++ / sampleRate);
+                block.setSample(0, i, value);
+                block.setSample(1, i, value);
+            }
+
+            analyser.push(block);
+        }
+    }
+
+    static void setParameter(VstTestPlaygroundAudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.apvts.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    juce::int64 sinePosition = 0;
+};
+
+// Register the test suite
+static SpectrumAnalyserTests spectrumAnalyserTests;
@@ -0,0 +1,108 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/Params.h"
+
+/**
+ * State Snapshot Tests for VstTestPlayground
+ * Tests that getStateInformation serialises the lock-free parameter snapshot
+ */
+class StateSnapshotTests : public juce::UnitTest
+{
+public:
+    StateSnapshotTests() : juce::UnitTest("State Snapshot Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Snapshot Matches APVTS Format");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            auto* gainParam = processor.apvts.getParameter(Params::GAIN_ID);
+            gainParam->setValueNotifyingHost(0.3f);
+
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+
+            auto xml = juce::AudioProcessor::getXmlFromBinary(state.getData(), static_cast<int>(state.getSize()));
+            expect(xml != nullptr, "State should be valid XML");
+            expect(xml->hasTagName(processor.apvts.state.getType()), "Root tag should match the APVTS state type");
+
+            auto* param = xml->getChildByAttribute("id", Params::GAIN_ID);
+            expect(param != nullptr && param->hasTagName("PARAM"), "Gain should be stored as a PARAM element");
+            expectWithinAbsoluteError((float) param->getDoubleAttribute("value"),
+                                      gainParam->convertFrom0to1(0.3f), 0.001f,
+                                      "Stored value should be the denormalised gain");
+        }
+
+        beginTest("Unchanged State Reuses Snapshot");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+
+            juce::MemoryBlock first, second;
+            processor.getStateInformation(first);
+            processor.getStateInformation(second);
+            expect(first == second, "Saving twice without changes should produce identical state");
+
+            processor.apvts.getParameter(Params::GAIN_ID)->setValueNotifyingHost(0.9f);
+
+            juce::MemoryBlock third;
+            processor.getStateInformation(third);
+            expect(third != second, "A parameter change should be reflected in the next save");
+        }
+
+        beginTest("Restored State Updates Snapshot");
+        {
+            VstTestPlaygroundAudioProcessor source, target;
+            source.apvts.getParameter(Params::GAIN_ID)->setValueNotifyingHost(0.2f);
+
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            target.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+            juce::MemoryBlock resaved;
+            target.getStateInformation(resaved);
+            expect(resaved == state, "Saving a restored processor should reproduce the same state");
+        }
+
+        beginTest("Concurrent Saves And Parameter Changes");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            auto* gainParam = processor.apvts.getParameter(Params::GAIN_ID);
+            std::atomic<bool> stop { false };
+
+            std::thread automation([&]
+            {
+                juce::Random random(1);
+                while (! stop.load())
+                    gainParam->setValueNotifyingHost(random.nextFloat());
+            });
+
+            int validStates = 0;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                juce::MemoryBlock state;
+                processor.getStateInformation(state);
+
+                if (auto xml = juce::AudioProcessor::getXmlFromBinary(state.getData(), static_cast<int>(state.getSize())))
+                    if (xml->getChildByAttribute("id", Params::GAIN_ID) != nullptr)
+                        ++validStates;
+            }
+
+            stop = true;
+            automation.join();
+
+            expectEquals(validStates, 2000, "Every save made during automation should be complete");
+
+            juce::MemoryBlock finalState;
+            processor.getStateInformation(finalState);
+            auto xml = juce::AudioProcessor::getXmlFromBinary(finalState.getData(), static_cast<int>(finalState.getSize()));
+            expectWithinAbsoluteError((float) xml->getChildByAttribute("id", Params::GAIN_ID)->getDoubleAttribute("value"),
+                                      gainParam->convertFrom0to1(gainParam->getValue()), 0.001f,
+                                      "Snapshot should settle on the last automated value");
+        }
+    }
+};
+
+// Register the test suite
+static StateSnapshotTests stateSnapshotTests;
@@ -0,0 +1,187 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/StreamingSampler.h"
+#include "TestHelpers.h"
+
+/**
+ * Streaming Sampler Tests for VstTestPlayground
+ * Tests the resident preload, disk streaming through the voice rings and underrun reporting
+ */
+class StreamingSamplerTests : public juce::UnitTest
+{
+public:
+    StreamingSamplerTests() : juce::UnitTest("Streaming Sampler Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Read-Ahead Follows The Block Size");
+        {
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            StreamingSampler sampler(loader, slot);
+
+            sampler.prepare(48000.0, 64);
+            const auto small = sampler.getReadAheadSamples();
+
+            sampler.prepare(48000.0, 2048);
+            const auto large = sampler.getReadAheadSamples();
+
+            expect(large > small, "Bigger blocks need more read-ahead");
+            expect(juce::isPowerOfTwo(large));
+            expectEquals(sampler.getPreloadSamples(), 2 * large);
+        }
+
+        beginTest("Streams Past The Preload To Match The File");
+        {
+            juce::TemporaryFile temp(".wav");
+            const auto source = makeNoise(sampleRate * 4);
+            expect(TestHelpers::writeWav(temp.getFile(), source, sampleRate));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            StreamingSampler sampler(loader, slot);
+            sampler.prepare(sampleRate, blockSize);
+
+            // Rendering as fast as possible, so the content can't depend on how quickly the disk keeps up
+            sampler.setWaitForDisk(true);
+            sampler.setSample(temp.getFile());
+            expect(loader.waitUntilIdle(10000));
+
+            {
+                AssetSlot<AudioAsset>::ScopedRead asset(slot);
+                expect(asset.get() != nullptr);
+                expectEquals(asset->audio.getNumSamples(), sampler.getPreloadSamples(), "Only the attack should be resident");
+                expectEquals(asset->fileLengthInSamples, (juce::int64) source.getNumSamples());
+            }
+
+            noteOn(sampler, 60);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            float maxError = 0.0f;
+
+            for (int start = 0; start + blockSize <= source.getNumSamples(); start += blockSize)
+            {
+                block.clear();
+                sampler.render(block, 0, blockSize);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    maxError = juce::jmax(maxError, std::abs(block.getSample(0, i) - source.getSample(0, start + i)));
+                    maxError = juce::jmax(maxError, std::abs(block.getSample(1, i) - source.getSample(0, start + i)));
+                }
+            }
+
+            expect(maxError < 1.0e-4f, "Streamed audio should match the file, max error " + juce::String(maxError));
+        }
+
+        beginTest("Counts Underruns When The Disk Can't Deliver");
+        {
+            juce::TemporaryFile temp(".wav");
+            const auto source = makeNoise(sampleRate * 4);
+            expect(TestHelpers::writeWav(temp.getFile(), source, sampleRate));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            StreamingSampler sampler(loader, slot);
+            sampler.prepare(sampleRate, blockSize);
+            sampler.setSample(temp.getFile());
+            expect(loader.waitUntilIdle(10000));
+
+            // The preload is in memory; the rest is gone
+            expect(temp.getFile().deleteFile());
+            noteOn(sampler, 60);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            const auto numBlocks = sampler.getPreloadSamples() / blockSize + 8;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                block.clear();
+                sampler.render(block, 0, blockSize);
+            }
+
+            expect(sampler.getNumUnderruns() > 0, "Blocks past the preload should be counted");
+            expect(sampler.getNumStarvedFrames() >= (juce::uint64) (7 * blockSize));
+            expectEquals(sampler.getNumActiveVoices(), 1, "A starved voice keeps its place");
+            expectEquals(block.getMagnitude(0, 0, blockSize), 0.0f, "Missing audio plays as silence");
+        }
+
+        beginTest("Stolen Voices Fade Out Instead Of Clicking");
+        {
+            // Half scale, faded in so a restart from the top starts quietly
+            juce::AudioBuffer<float> source(1, sampleRate);
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(0, i, 0.5f * juce::jmin(1.0f, (float) i / 100.0f));
+
+            juce::TemporaryFile temp(".wav");
+            expect(TestHelpers::writeWav(temp.getFile(), source, sampleRate));
+
+            AssetSlot<AudioAsset> slot;
+            AssetLoader loader;
+            StreamingSampler sampler(loader, slot);
+            sampler.prepare(sampleRate, blockSize);
+            sampler.setSample(temp.getFile());
+            expect(loader.waitUntilIdle(10000));
+
+            for (int v = 0; v < StreamingSampler::maxVoices; ++v)
+                noteOn(sampler, 60);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            block.clear();
+            sampler.render(block, 0, blockSize);
+            auto previous = block.getSample(0, blockSize - 1);
+
+            // Every voice is busy, so this takes the oldest
+            noteOn(sampler, 60);
+            expectEquals(sampler.getNumActiveVoices(), StreamingSampler::maxVoices);
+
+            float maxStep = 0.0f;
+
+            for (int b = 0; b < 4; ++b)
+            {
+                block.clear();
+                sampler.render(block, 0, blockSize);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    maxStep = juce::jmax(maxStep, std::abs(block.getSample(0, i) - previous));
+                    previous = block.getSample(0, i);
+                }
+            }
+
+            // Cutting a voice off would drop the output by a whole voice, 0.5, in one sample
+            expect(maxStep < 0.02f, "The steal should be a short fade, largest step " + juce::String(maxStep));
+            expectWithinAbsoluteError(previous, 0.5f * StreamingSampler::maxVoices, 1.0e-3f,
+                                      "The new note should have taken over the voice");
+        }
+    }
+
+private:
+    static constexpr int sampleRate = 44100;
+    static constexpr int blockSize = 512;
+
+    static void noteOn(StreamingSampler& sampler, int note)
+    {
+        PreparsedMidiBuffer parsed;
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 127), 0);
+        parsed.parse(midi, blockSize);
+
+        for (auto& event : parsed)
+            sampler.handleEvent(event);
+    }
+
+    static juce::AudioBuffer<float> makeNoise(int numSamples)
+    {
+        juce::AudioBuffer<float> buffer(1, numSamples);
+        juce::Random random(7);
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(0, i, random.nextFloat() - 0.5f);
+
+        return buffer;
+    }
+};
+
+// Register the test suite
+static StreamingSamplerTests streamingSamplerTests;
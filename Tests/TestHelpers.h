@@ -0,0 +1,29 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+/**
+ * Helpers shared by the test suites
+ */
+namespace TestHelpers
+{
+    /** Writes buffer to file as a 32-bit float WAV, replacing what's there. */
+    inline bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            (unsigned int) buffer.getNumChannels(),
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // now owned by the writer
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+}
@@ -3,6 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../Source/PluginProcessor.h"
 #include "../Source/PluginEditor.h"
+#include "../Source/NativeControls.h"
 #include "../Source/Params.h"
 
 /**
@@ -205,6 +206,73 @@ public:
             
             delete editor;
         }
+
+        beginTest("Meters Repaint Only What Moved");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            NativeControls controls(processor);
+            controls.setSize(400, 300);
+
+            auto dirty = controls.setMeterLevels(0.5f, 0.5f);
+            expect(! dirty.isEmpty(), "A new level should need repainting");
+            expect(dirty.getBounds().getWidth() < 100, "Only the meters should be dirty");
+
+            expect(controls.setMeterLevels(0.5f, 0.5f).isEmpty(), "An unchanged level should repaint nothing");
+
+            dirty = controls.setMeterLevels(0.5f, 0.51f);
+            expect(dirty.getBounds().getHeight() <= 2, "A small change should repaint a sliver");
+        }
+
+        beginTest("Cached Layers Paint The Same As A Full Repaint");
+        {
+            VstTestPlaygroundAudioProcessor processor;
+            CustomLookAndFeel lookAndFeel;
+
+            auto render = [&] (bool cached)
+            {
+                lookAndFeel.setLayerCachingEnabled(cached);
+
+                NativeControls controls(processor);
+                controls.setLookAndFeel(&lookAndFeel);
+                controls.setLayerCachingEnabled(cached);
+                controls.setSize(400, 300);
+                controls.setMeterLevels(0.3f, 0.6f);
+                controls.getGainSlider().setValue(-6.0, juce::dontSendNotification);
+
+                juce::Image image(juce::Image::ARGB, 400, 300, true, juce::SoftwareImageType());
+
+                // Twice, so the cached render comes from the images
+                for (int i = 0; i < 2; ++i)
+                {
+                    juce::Graphics g(image);
+                    controls.paintEntireComponent(g, false);
+                }
+
+                controls.setLookAndFeel(nullptr);
+                return image;
+            };
+
+            const auto full = render(false);
+            const auto cached = render(true);
+
+            int numDifferent = 0;
+            for (int y = 0; y < 300; ++y)
+            {
+                for (int x = 0; x < 400; ++x)
+                {
+                    const auto a = full.getPixelAt(x, y);
+                    const auto b = cached.getPixelAt(x, y);
+                    const auto difference = juce::jmax(std::abs((int) a.getRed() - (int) b.getRed()),
+                                                       std::abs((int) a.getGreen() - (int) b.getGreen()),
+                                                       std::abs((int) a.getBlue() - (int) b.getBlue()));
+                    if (difference > 8)
+                        ++numDifferent;
+                }
+            }
+
+            // Antialiased edges may round differently through an image, but nothing more
+            expect(numDifferent < 400 * 300 / 100, juce::String(numDifferent) + " pixels differ");
+        }
     }
 };
 
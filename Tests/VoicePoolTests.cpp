@@ -0,0 +1,182 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/MpeVoicePool.h"
+#include "../Source/PreparsedMidiBuffer.h"
+
+/**
+ * Voice Pool Tests for VstTestPlayground
+ * Tests voice allocation and MPE per-note expression routing in MpeVoicePool
+ */
+class VoicePoolTests : public juce::UnitTest
+{
+public:
+    VoicePoolTests() : juce::UnitTest("Voice Pool Tests for VstTestPlayground") {}
+
+    void runTest() override
+    {
+        beginTest("Notes Sound And Release");
+        {
+            MpeVoicePool pool;
+            PreparsedMidiBuffer parsed;
+            pool.prepare(48000.0, 512);
+
+            juce::AudioBuffer<float> block(2, 512);
+            block.clear();
+
+            send(pool, parsed, { juce::MidiMessage::noteOn(1, 69, (juce::uint8) 127) });
+            pool.render(block, 0, 512);
+
+            expectEquals(pool.getNumActiveVoices(), 1);
+            expect(block.getMagnitude(0, 0, 512) > 0.05f, "A held note should be audible");
+            expectEquals(block.getMagnitude(0, 0, 512), block.getMagnitude(1, 0, 512), "Voices are mono in every channel");
+
+            send(pool, parsed, { juce::MidiMessage::noteOff(1, 69) });
+            expectEquals(pool.findVoice(1, 69), -1, "A released voice is no longer found by note");
+
+            // 50ms release
+            for (int i = 0; i < 8; ++i)
+                pool.render(block, 0, 512);
+
+            expectEquals(pool.getNumActiveVoices(), 0, "The voice should free itself after its release");
+        }
+
+        beginTest("Voices Are Stolen Oldest First");
+        {
+            MpeVoicePool pool;
+            PreparsedMidiBuffer parsed;
+            pool.prepare(48000.0, 512);
+
+            for (int i = 0; i < MpeVoicePool::maxVoices + 4; ++i)
+                send(pool, parsed, { juce::MidiMessage::noteOn(1, 20 + i, (juce::uint8) 100) });
+
+            expectEquals(pool.getNumActiveVoices(), MpeVoicePool::maxVoices);
+            expectEquals(pool.findVoice(1, 20), -1, "The oldest note should have been stolen");
+            expect(pool.findVoice(1, 20 + MpeVoicePool::maxVoices + 3) >= 0, "The newest note should be playing");
+        }
+
+        beginTest("Stolen Voices Fade Out Instead Of Clicking");
+        {
+            // Two pools holding every voice on the same note; one then has a voice stolen
+            MpeVoicePool pool, reference;
+            PreparsedMidiBuffer parsed;
+
+            for (auto* p : { &pool, &reference })
+            {
+                p->prepare(48000.0, 1024);
+
+                for (int v = 0; v < MpeVoicePool::maxVoices; ++v)
+                    send(*p, parsed, { juce::MidiMessage::noteOn(1, 69, (juce::uint8) 127) });
+            }
+
+            // Past the attack, stopping where 440Hz is near its peak, where a cut would click loudest
+            const auto warmUp = 573;
+            juce::AudioBuffer<float> block(1, 1024), expected(1, 1024);
+            block.clear();
+            expected.clear();
+            pool.render(block, 0, warmUp);
+            reference.render(expected, 0, warmUp);
+
+            send(pool, parsed, { juce::MidiMessage::noteOn(1, 81, (juce::uint8) 127) });
+            expectEquals(pool.getNumActiveVoices(), MpeVoicePool::maxVoices);
+            expect(pool.findVoice(1, 81) >= 0, "The stolen voice should answer to its new note at once");
+
+            block.clear();
+            expected.clear();
+            pool.render(block, 0, 1024);
+            reference.render(expected, 0, 1024);
+
+            // The difference is the stolen note leaving and the new one arriving
+            float maxStep = 0.0f, previous = 0.0f;
+
+            for (int i = 0; i < 1024; ++i)
+            {
+                const auto difference = block.getSample(0, i) - expected.getSample(0, i);
+                maxStep = juce::jmax(maxStep, std::abs(difference - previous));
+                previous = difference;
+            }
+
+            // Cutting a voice off near its peak would jump by its whole amplitude, about 0.125
+            expect(maxStep < 0.02f, "The steal should be a short fade, largest step " + juce::String(maxStep));
+        }
+
+        beginTest("MPE Expression Is Per Note");
+        {
+            MpeVoicePool pool;
+            PreparsedMidiBuffer parsed;
+            pool.prepare(48000.0, 512);
+
+            juce::MidiBuffer zone = juce::MPEMessages::setLowerZone(15);
+            parsed.parse(zone, 64);
+
+            send(pool, parsed, { juce::MidiMessage::noteOn(2, 60, (juce::uint8) 100),
+                                 juce::MidiMessage::noteOn(3, 64, (juce::uint8) 100),
+                                 juce::MidiMessage::pitchWheel(2, 8192 + 4096),
+                                 juce::MidiMessage::channelPressureChange(3, 127),
+                                 juce::MidiMessage::controllerEvent(3, 74, 127) });
+            settle(pool);
+
+            const auto first = pool.findVoice(2, 60);
+            const auto second = pool.findVoice(3, 64);
+            expect(first >= 0 && second >= 0);
+
+            expectWithinAbsoluteError(pool.getExpression(first, MpeVoicePool::noteBend), 24.0f, 0.1f,
+                                      "Half a bend at 48 semitones should reach 24 semitones");
+            expectWithinAbsoluteError(pool.getExpression(second, MpeVoicePool::noteBend), 0.0f, 1.0e-6f,
+                                      "Another note's bend must not move");
+            expectWithinAbsoluteError(pool.getExpression(second, MpeVoicePool::pressure), 1.0f, 0.01f);
+            expectWithinAbsoluteError(pool.getExpression(second, MpeVoicePool::timbre), 1.0f, 0.01f);
+            expectWithinAbsoluteError(pool.getExpression(first, MpeVoicePool::pressure), 0.0f, 1.0e-6f);
+
+            // The master channel bends the whole zone
+            send(pool, parsed, { juce::MidiMessage::pitchWheel(1, 16383) });
+            settle(pool);
+
+            expectWithinAbsoluteError(pool.getExpression(first, MpeVoicePool::masterBend), 2.0f, 0.01f);
+            expectWithinAbsoluteError(pool.getExpression(second, MpeVoicePool::masterBend), 2.0f, 0.01f);
+        }
+
+        beginTest("Notes Start From Their Channel's Expression");
+        {
+            MpeVoicePool pool;
+            PreparsedMidiBuffer parsed;
+            pool.prepare(48000.0, 512);
+
+            juce::MidiBuffer zone = juce::MPEMessages::setLowerZone(15);
+            parsed.parse(zone, 64);
+
+            // MPE controllers send the initial bend and timbre just before the note
+            send(pool, parsed, { juce::MidiMessage::pitchWheel(4, 0),
+                                 juce::MidiMessage::noteOn(4, 72, (juce::uint8) 100) });
+
+            const auto voice = pool.findVoice(4, 72);
+            expectWithinAbsoluteError(pool.getExpression(voice, MpeVoicePool::noteBend), -48.0f, 1.0e-3f,
+                                      "The note should start bent without gliding");
+        }
+    }
+
+private:
+    /** Parses the messages as one block and hands every event to the pool. */
+    static void send(MpeVoicePool& pool, PreparsedMidiBuffer& parsed, std::initializer_list<juce::MidiMessage> messages)
+    {
+        juce::MidiBuffer midi;
+        for (auto& m : messages)
+            midi.addEvent(m, 0);
+
+        parsed.parse(midi, 64);
+
+        for (auto& e : parsed)
+            pool.handleEvent(e, parsed.getZoneLayout());
+    }
+
+    /** Renders long enough for the expression lanes to reach their targets. */
+    static void settle(MpeVoicePool& pool)
+    {
+        juce::AudioBuffer<float> block(1, 512);
+
+        for (int i = 0; i < 8; ++i)
+            pool.render(block, 0, 512);
+    }
+};
+
+// Register the test suite
+static VoicePoolTests voicePoolTests;
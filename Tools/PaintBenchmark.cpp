@@ -0,0 +1,148 @@
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PluginProcessor.h"
+#include "NativeControls.h"
+#include "CustomLookAndFeel.h"
+#include "ToolHelpers.h"
+
+#include <iostream>
+
+/**
+    Native UI paint benchmark.
+
+    Simulates many open editors showing the native controls, each with moving
+    meters and a knob that changes every few frames, and times the message
+    thread's painting two ways:
+    - full: no layer caches, and the whole panel painted every frame, which
+      is what a timer calling repaint() on the editor used to cost;
+    - cached: layer caches on, and only the regions the meters and knob
+      reported as dirty painted, as the VBlankAttachment-driven path does.
+    Everything is painted into a software image, so the numbers are the
+    rendering cost alone, without the OS compositor.
+
+    Usage: VstTestPlayground_PaintBenchmark [--frames 240] [--width 400] [--height 300]
+*/
+namespace
+{
+    using ToolHelpers::column;
+
+    constexpr int editorCounts[] = { 1, 4, 16, 64 };
+    constexpr int knobInterval = 8;     /**< Frames between knob moves. */
+
+    /** Returns microseconds of painting per frame for numEditors panels. */
+    double timeFrames(VstTestPlaygroundAudioProcessor& processor, int numEditors, bool cached,
+                      int numFrames, int width, int height)
+    {
+        juce::OwnedArray<CustomLookAndFeel> lookAndFeels;
+        juce::OwnedArray<NativeControls> panels;
+
+        for (int i = 0; i < numEditors; ++i)
+        {
+            auto* lookAndFeel = lookAndFeels.add(new CustomLookAndFeel());
+            lookAndFeel->setLayerCachingEnabled(cached);
+
+            auto* panel = panels.add(new NativeControls(processor));
+            panel->setLookAndFeel(lookAndFeel);
+            panel->setLayerCachingEnabled(cached);
+            panel->setSize(width, height);
+        }
+
+        juce::Image canvas(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+        juce::Random random(42);
+        juce::int64 ticks = 0;
+
+        // Frame -1 warms the caches up and isn't timed
+        for (int frame = -1; frame < numFrames; ++frame)
+        {
+            for (auto* panel : panels)
+            {
+                // New peaks every frame, so both meters always have something to repaint
+                auto dirty = panel->setMeterLevels(random.nextFloat(), random.nextFloat());
+
+                if (frame % knobInterval == 0)
+                {
+                    auto& knob = panel->getGainSlider();
+                    knob.setValue(knob.getMinimum() + random.nextDouble() * (knob.getMaximum() - knob.getMinimum()),
+                                  juce::dontSendNotification);
+                    dirty.add(knob.getBoundsInParent());
+                }
+
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                {
+                    juce::Graphics g(canvas);
+
+                    if (cached && frame >= 0)
+                        g.reduceClipRegion(dirty);
+
+                    if (! g.isClipEmpty())
+                        panel->paintEntireComponent(g, false);
+                }
+
+                if (frame >= 0)
+                    ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+        }
+
+        for (auto* panel : panels)
+            panel->setLookAndFeel(nullptr);
+
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6 / numFrames;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    auto numFrames = 240;
+    auto width = 400;
+    auto height = 300;
+
+    if (auto index = args.indexOf("--frames"); index >= 0 && index + 1 < args.size())
+        numFrames = juce::jmax(1, args[index + 1].getIntValue());
+
+    if (auto index = args.indexOf("--width"); index >= 0 && index + 1 < args.size())
+        width = juce::jmax(100, args[index + 1].getIntValue());
+
+    if (auto index = args.indexOf("--height"); index >= 0 && index + 1 < args.size())
+        height = juce::jmax(100, args[index + 1].getIntValue());
+
+    VstTestPlaygroundAudioProcessor processor;
+
+    std::cout << "VstTestPlayground paint benchmark: " << width << "x" << height << " native controls, "
+              << numFrames << " frames, knob moves every " << knobInterval << " frames\n\n"
+              << column("editors", 8) << column("full us/frame", 15) << column("cached us/frame", 17)
+              << column("speedup", 9) << std::endl;
+
+    juce::StringArray warnings;
+
+    for (auto numEditors : editorCounts)
+    {
+        const auto full = timeFrames(processor, numEditors, false, numFrames, width, height);
+        const auto cached = timeFrames(processor, numEditors, true, numFrames, width, height);
+        const auto speedup = full / juce::jmax(1.0e-9, cached);
+
+        std::cout << column(juce::String(numEditors), 8)
+                  << column(juce::String(full, 1), 15)
+                  << column(juce::String(cached, 1), 17)
+                  << column(juce::String(speedup, 1) + "x", 9) << std::endl;
+
+        if (speedup < 1.0)
+            warnings.add(juce::String(numEditors) + " editors: cached painting is slower than full repaints");
+    }
+
+    if (! warnings.isEmpty())
+    {
+        std::cout << "\n";
+
+        for (auto& w : warnings)
+            std::cout << "WARNING: " << w << "\n";
+    }
+
+    return 0;
+}
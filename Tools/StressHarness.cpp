@@ -0,0 +1,295 @@
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginProcessor.h"
+#include "Params.h"
+#include "ToolHelpers.h"
+
+#include <iostream>
+
+/**
+    Multi-instance stress harness.
+
+    Instantiates N processors, one per simulated track, and drives them from a
+    thread pool the way a DAW graph does: every cycle all tracks are processed
+    in parallel and the cycle ends when the last one finishes. Automation is
+    randomised on the worker threads while a separate thread keeps saving and
+    restoring state, like host autosave and preset recall.
+
+    For each instance count it reports aggregate throughput, per-instance
+    jitter and how much a single instance's block cost grows relative to
+    running alone; growth beyond what the core count explains points at
+    contention or false sharing.
+
+    Usage: VstTestPlayground_StressHarness [--max-instances 256] [--threads N]
+                                           [--block-size 256] [--sample-rate 48000]
+                                           [--seconds 2]
+*/
+namespace
+{
+    using ToolHelpers::column;
+
+    struct Options
+    {
+        int maxInstances = 256;
+        int numThreads = juce::SystemStats::getNumCpus();
+        int blockSize = 256;
+        double sampleRate = 48000.0;
+        double seconds = 2.0;
+    };
+
+    Options parseOptions(const juce::StringArray& args)
+    {
+        Options options;
+
+        auto intArg = [&] (const char* name, int& value)
+        {
+            auto index = args.indexOf(name);
+            if (index >= 0 && index + 1 < args.size())
+                value = juce::jmax(1, args[index + 1].getIntValue());
+        };
+
+        auto doubleArg = [&] (const char* name, double& value)
+        {
+            auto index = args.indexOf(name);
+            if (index >= 0 && index + 1 < args.size())
+                value = juce::jmax(0.01, args[index + 1].getDoubleValue());
+        };
+
+        intArg("--max-instances", options.maxInstances);
+        intArg("--threads", options.numThreads);
+        intArg("--block-size", options.blockSize);
+        doubleArg("--sample-rate", options.sampleRate);
+        doubleArg("--seconds", options.seconds);
+        return options;
+    }
+
+    //==============================================================================
+    /** Per-instance timing, padded to its own cache line so the harness itself doesn't false-share. */
+    struct alignas(64) InstanceStats
+    {
+        double sum = 0.0;
+        double sumOfSquares = 0.0;
+        double max = 0.0;
+        int count = 0;
+
+        void add(double micros) noexcept
+        {
+            sum += micros;
+            sumOfSquares += micros * micros;
+            max = juce::jmax(max, micros);
+            ++count;
+        }
+
+        double mean() const noexcept            { return count > 0 ? sum / count : 0.0; }
+        double standardDeviation() const noexcept
+        {
+            return count > 1 ? std::sqrt(juce::jmax(0.0, sumOfSquares / count - mean() * mean())) : 0.0;
+        }
+    };
+
+    struct Track
+    {
+        std::unique_ptr<VstTestPlaygroundAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::Random random;
+        InstanceStats stats;
+    };
+
+    struct RunResult
+    {
+        int numInstances = 0;
+        double wallSeconds = 0.0;
+        double meanCycleMicros = 0.0;
+        double worstCycleMicros = 0.0;
+        int overruns = 0;
+        double meanInstanceMicros = 0.0;
+        double meanJitterMicros = 0.0;
+        double worstInstanceMicros = 0.0;
+        int stateOperations = 0;
+    };
+
+    //==============================================================================
+    /** Saves and restores state on random instances while the graph is running. */
+    class StateChurnThread : public juce::Thread
+    {
+    public:
+        explicit StateChurnThread(std::vector<std::unique_ptr<Track>>& t)
+            : juce::Thread("State churn"), tracks(t) {}
+
+        void run() override
+        {
+            juce::Random random(0x57a7e);
+            juce::MemoryBlock state;
+
+            while (! threadShouldExit())
+            {
+                auto& source = *tracks[(size_t) random.nextInt((int) tracks.size())]->processor;
+                source.getStateInformation(state);
+
+                if (random.nextInt(4) == 0)
+                {
+                    auto& target = *tracks[(size_t) random.nextInt((int) tracks.size())]->processor;
+                    target.setStateInformation(state.getData(), (int) state.getSize());
+                }
+
+                operations.fetch_add(1, std::memory_order_relaxed);
+                wait(2);
+            }
+        }
+
+        std::atomic<int> operations { 0 };
+
+    private:
+        std::vector<std::unique_ptr<Track>>& tracks;
+    };
+
+    //==============================================================================
+    RunResult run(const Options& options, int numInstances, juce::ThreadPool& pool)
+    {
+        std::vector<std::unique_ptr<Track>> tracks;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto track = std::make_unique<Track>();
+            track->processor = std::make_unique<VstTestPlaygroundAudioProcessor>();
+            track->processor->setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+            track->processor->prepareToPlay(options.sampleRate, options.blockSize);
+            track->buffer.setSize(juce::jmax(track->processor->getTotalNumInputChannels(),
+                                             track->processor->getTotalNumOutputChannels()),
+                                  options.blockSize);
+            track->random.setSeed(i + 1);
+            tracks.push_back(std::move(track));
+        }
+
+        StateChurnThread churn(tracks);
+        churn.startThread();
+
+        const auto numCycles = juce::jmax(1, (int) (options.seconds * options.sampleRate / options.blockSize));
+        const auto budgetMicros = 1.0e6 * options.blockSize / options.sampleRate;
+
+        std::atomic<int> remaining { 0 };
+        juce::WaitableEvent cycleDone;
+
+        RunResult result;
+        result.numInstances = numInstances;
+
+        const auto runStart = juce::Time::getHighResolutionTicks();
+
+        for (int cycle = 0; cycle < numCycles; ++cycle)
+        {
+            remaining.store(numInstances);
+            const auto cycleStart = juce::Time::getHighResolutionTicks();
+
+            for (auto& t : tracks)
+            {
+                pool.addJob([&track = *t, &remaining, &cycleDone]
+                {
+                    auto& buffer = track.buffer;
+
+                    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        for (int i = 0; i < buffer.getNumSamples(); ++i)
+                            buffer.setSample(ch, i, track.random.nextFloat() * 0.5f - 0.25f);
+
+                    if (track.random.nextInt(4) == 0)
+                        track.processor->apvts.getParameter(Params::GAIN_ID)->setValueNotifyingHost(track.random.nextFloat());
+
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    track.processor->processBlock(buffer, track.midi);
+                    track.stats.add(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6);
+
+                    if (remaining.fetch_sub(1) == 1)
+                        cycleDone.signal();
+                });
+            }
+
+            cycleDone.wait();
+
+            const auto cycleMicros = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - cycleStart) * 1.0e6;
+            result.meanCycleMicros += cycleMicros / numCycles;
+            result.worstCycleMicros = juce::jmax(result.worstCycleMicros, cycleMicros);
+
+            if (cycleMicros > budgetMicros)
+                ++result.overruns;
+        }
+
+        result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - runStart);
+
+        churn.stopThread(1000);
+        result.stateOperations = churn.operations.load();
+
+        for (auto& t : tracks)
+        {
+            result.meanInstanceMicros += t->stats.mean() / numInstances;
+            result.meanJitterMicros += t->stats.standardDeviation() / numInstances;
+            result.worstInstanceMicros = juce::jmax(result.worstInstanceMicros, t->stats.max);
+            t->processor->releaseResources();
+        }
+
+        return result;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const auto options = parseOptions(args);
+    juce::ThreadPool pool(options.numThreads);
+
+    std::cout << "VstTestPlayground stress harness: " << options.numThreads << " worker threads, "
+              << options.blockSize << " samples @ " << options.sampleRate << " Hz, "
+              << options.seconds << " s of audio per run\n\n";
+
+    std::cout << column("tracks", 7) << column("x realtime", 12) << column("cycle avg us", 14)
+              << column("cycle max us", 14) << column("overruns", 10) << column("block avg us", 14)
+              << column("jitter us", 11) << column("block max us", 14) << column("cost growth", 13)
+              << column("state ops", 11) << "\n";
+
+    double soloMicros = 0.0;
+    juce::StringArray warnings;
+
+    for (int numInstances = 1; numInstances <= options.maxInstances; numInstances *= 2)
+    {
+        const auto r = run(options, numInstances, pool);
+
+        if (numInstances == 1)
+            soloMicros = r.meanInstanceMicros;
+
+        const auto audioSeconds = options.seconds * numInstances;
+        const auto growth = soloMicros > 0.0 ? r.meanInstanceMicros / soloMicros : 1.0;
+
+        std::cout << column(juce::String(numInstances), 7)
+                  << column(juce::String(audioSeconds / r.wallSeconds, 1), 12)
+                  << column(juce::String(r.meanCycleMicros, 1), 14)
+                  << column(juce::String(r.worstCycleMicros, 1), 14)
+                  << column(juce::String(r.overruns), 10)
+                  << column(juce::String(r.meanInstanceMicros, 2), 14)
+                  << column(juce::String(r.meanJitterMicros, 2), 11)
+                  << column(juce::String(r.worstInstanceMicros, 1), 14)
+                  << column(juce::String(growth, 2) + "x", 13)
+                  << column(juce::String(r.stateOperations), 11) << std::endl;
+
+        // Once every worker is busy each instance should still cost about what it
+        // cost alone; a clear rise means the instances are fighting over shared
+        // cache lines, locks or memory bandwidth.
+        if (growth > 1.5)
+            warnings.add(juce::String(numInstances) + " tracks: per-instance block cost is "
+                         + juce::String(growth, 2) + "x the solo cost, suspect contention or false sharing");
+    }
+
+    if (! warnings.isEmpty())
+    {
+        std::cout << "\n";
+
+        for (auto& w : warnings)
+            std::cout << "WARNING: " << w << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    Helpers shared by the command-line tools.
+*/
+namespace ToolHelpers
+{
+    /** text right-aligned in a column width characters wide, for the result tables. */
+    inline juce::String column(const juce::String& text, int width)
+    {
+        return text.paddedLeft(' ', width);
+    }
+}
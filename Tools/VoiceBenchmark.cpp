@@ -0,0 +1,144 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "MpeVoicePool.h"
+#include "PreparsedMidiBuffer.h"
+#include "ToolHelpers.h"
+
+#include <iostream>
+
+/**
+    Voice pool expression benchmark.
+
+    Renders the same held chord twice at each voice count: once as plain MIDI,
+    and once as a dense MPE performance where every note gets a new pitch
+    bend, pressure and timbre value every 32 samples. Both runs go through
+    PreparsedMidiBuffer and MpeVoicePool exactly as processBlock() does, so
+    the ratio between them is the real cost of expression. It should stay
+    close to 1x; anything above 1.1x is printed as a warning.
+
+    Usage: VstTestPlayground_VoiceBenchmark [--sample-rate 48000] [--block-size 256] [--seconds 2]
+*/
+namespace
+{
+    using ToolHelpers::column;
+
+    constexpr int voiceCounts[] = { 1, 4, 8, 16, 32 };
+    constexpr int expressionInterval = 32;
+
+    /** Returns ns per sample of parsing, dispatching and rendering numVoices MPE notes. */
+    double timePerformance(int numVoices, bool expressive, double sampleRate, int blockSize, double seconds)
+    {
+        MpeVoicePool pool;
+        PreparsedMidiBuffer parsed;
+        juce::MidiBuffer midi;
+        juce::AudioBuffer<float> block(2, blockSize);
+
+        pool.prepare(sampleRate, blockSize);
+
+        // One note per member channel, wrapping onto shared channels past 15 voices
+        midi = juce::MPEMessages::setLowerZone(15);
+        for (int v = 0; v < numVoices; ++v)
+            midi.addEvent(juce::MidiMessage::noteOn(2 + v % 15, 48 + v, (juce::uint8) 100), 0);
+
+        const auto numBlocks = juce::jmax(1, (int) (sampleRate * seconds) / blockSize);
+        juce::Random random(99);
+        juce::int64 ticks = 0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            if (expressive)
+            {
+                for (int pos = 0; pos < blockSize; pos += expressionInterval)
+                {
+                    for (int v = 0; v < numVoices; ++v)
+                    {
+                        const auto channel = 2 + v % 15;
+                        midi.addEvent(juce::MidiMessage::pitchWheel(channel, random.nextInt(16384)), pos);
+                        midi.addEvent(juce::MidiMessage::channelPressureChange(channel, random.nextInt(128)), pos);
+                        midi.addEvent(juce::MidiMessage::controllerEvent(channel, 74, random.nextInt(128)), pos);
+                    }
+                }
+            }
+
+            block.clear();
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            parsed.parse(midi, blockSize);
+
+            int position = 0;
+            for (auto& event : parsed)
+            {
+                if (event.sampleOffset > position)
+                {
+                    pool.render(block, position, event.sampleOffset - position);
+                    position = event.sampleOffset;
+                }
+
+                pool.handleEvent(event, parsed.getZoneLayout());
+            }
+
+            pool.render(block, position, blockSize - position);
+
+            ticks += juce::Time::getHighResolutionTicks() - start;
+            midi.clear();
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / ((double) numBlocks * blockSize);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    auto sampleRate = 48000.0;
+    auto blockSize = 256;
+    auto seconds = 2.0;
+
+    if (auto index = args.indexOf("--sample-rate"); index >= 0 && index + 1 < args.size())
+        sampleRate = juce::jmax(8000.0, args[index + 1].getDoubleValue());
+
+    if (auto index = args.indexOf("--block-size"); index >= 0 && index + 1 < args.size())
+        blockSize = juce::jmax(16, args[index + 1].getIntValue());
+
+    if (auto index = args.indexOf("--seconds"); index >= 0 && index + 1 < args.size())
+        seconds = juce::jmax(0.01, args[index + 1].getDoubleValue());
+
+    juce::ScopedNoDenormals noDenormals;
+
+    std::cout << "VstTestPlayground voice benchmark: " << blockSize << " samples @ " << sampleRate << " Hz, "
+              << "expression every " << expressionInterval << " samples per note\n\n"
+              << column("voices", 7) << column("plain ns/sample", 17) << column("MPE ns/sample", 15)
+              << column("ratio", 8) << std::endl;
+
+    juce::StringArray warnings;
+
+    for (auto numVoices : voiceCounts)
+    {
+        const auto plain = timePerformance(numVoices, false, sampleRate, blockSize, seconds);
+        const auto expressive = timePerformance(numVoices, true, sampleRate, blockSize, seconds);
+        const auto ratio = expressive / juce::jmax(1.0e-9, plain);
+
+        std::cout << column(juce::String(numVoices), 7)
+                  << column(juce::String(plain, 2), 17)
+                  << column(juce::String(expressive, 2), 15)
+                  << column(juce::String(ratio, 2) + "x", 8) << std::endl;
+
+        if (ratio > 1.1)
+            warnings.add(juce::String(numVoices) + " voices: MPE expression costs " + juce::String(ratio, 2)
+                         + "x plain MIDI");
+    }
+
+    if (! warnings.isEmpty())
+    {
+        std::cout << "\n";
+
+        for (auto& w : warnings)
+            std::cout << "WARNING: " << w << "\n";
+    }
+
+    return 0;
+}